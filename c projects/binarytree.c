@@ -2,138 +2,1590 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#define BPLUS_LEAF_KEYS 125 // 4 + 125 * 4 + 8 = 512 bytes, eight cache lines
+#define BPLUS_INNER_KEYS 63 // 4 + 63 * 4 + 64 * 8 = 768 bytes; a search reads the four lines of keys and one of children
+#define CACHE_LINE_SIZE 64
+#define ARENA_BLOCK_SHIFT 20 // 1M compact nodes, 16 MB, per arena block
+#define ARENA_BLOCK_NODES (1u << ARENA_BLOCK_SHIFT)
+#define ARENA_NULL 0u // Index 0 is never handed out, so it can stand for NULL
+#define TRAVERSAL_BATCH 256 // Keys pulled from an iterator per call by the printing traversals
+#define FROZEN_PREFETCH_LEVELS 4 // 2^4 ints = one cache line, so keys four levels down share one line
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
+enum TreeMode {
+    TREE_UNBALANCED, // Shape follows the insertion order, sorted input makes a list
+    TREE_AVL // Rotated after each insert so the height stays below 1.44 log2(n + 2)
+};
+enum TraversalOrder {
+    ORDER_INORDER,
+    ORDER_PREORDER,
+    ORDER_POSTORDER
+};
 struct node {
     int data;
+    int height; // Of the subtree rooted here, 0 for a leaf; always kept current by insert
     struct node *left;
     struct node *right;
+    // Metrics of the subtree rooted here, current while the tree's augmented flag is on
+    // or right after computeMetrics, stale otherwise
+    int size;
+    int diameter; // Longest path in edges
+    int min;
+    int max;
+    long long sum; // Of the keys, for range sums
+};
+// A tree and the options its inserts follow. Each tree carries its own, so switching
+// one tree's mode never leaves another tree's fields stale
+struct tree {
+    struct node* root;
+    enum TreeMode mode; // Applies to later inserts, the current shape is kept
+    int augmented; // Keep size, sum, diameter, min and max current on every node; see setAugmentedMetrics
+};
+// Everything computeMetrics gathers in its one pass
+struct treeMetrics {
+    int size;
+    int height; // -1 for an empty tree
+    int diameter;
+    int min; // -1 for an empty tree, like findMin
+    int max;
+    long long sum;
 };
 struct node* createNode(int data) {
     struct node* newNode = (struct node*)malloc(sizeof(struct node));
+    if (newNode == NULL) {
+        return NULL; // Out of memory
+    }
     newNode->data = data;
+    newNode->height = 0;
     newNode->left = NULL;
     newNode->right = NULL;
+    newNode->size = 1;
+    newNode->diameter = 0;
+    newNode->min = data;
+    newNode->max = data;
+    newNode->sum = data;
     return newNode;
 }
-void insert(struct node** root, int data) {
-    if (*root == NULL) {
-        *root = createNode(data);
-    } else if (data < (*root)->data) {
-        insert(&((*root)->left), data);
+int nodeHeight(struct node* root) {
+    return root == NULL ? -1 : root->height;
+}
+void updateMetrics(struct node* root) {
+    // Recomputes the node's fields from its children's, which must already be current
+    int leftHeight = nodeHeight(root->left);
+    int rightHeight = nodeHeight(root->right);
+    root->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+    root->size = 1 + (root->left ? root->left->size : 0) + (root->right ? root->right->size : 0);
+    root->sum = root->data + (root->left ? root->left->sum : 0) + (root->right ? root->right->sum : 0);
+    root->diameter = leftHeight + rightHeight + 2; // Longest path through this node
+    if (root->left && root->left->diameter > root->diameter) root->diameter = root->left->diameter;
+    if (root->right && root->right->diameter > root->diameter) root->diameter = root->right->diameter;
+    root->min = root->left ? root->left->min : root->data;
+    root->max = root->right ? root->right->max : root->data;
+}
+void updateHeight(struct node* root, int augmented) {
+    if (augmented) {
+        updateMetrics(root);
+        return;
+    }
+    int leftHeight = nodeHeight(root->left);
+    int rightHeight = nodeHeight(root->right);
+    root->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+}
+struct node* rotateRight(struct node* root, int augmented) {
+    struct node* newRoot = root->left;
+    root->left = newRoot->right;
+    newRoot->right = root;
+    updateHeight(root, augmented);
+    updateHeight(newRoot, augmented);
+    return newRoot;
+}
+struct node* rotateLeft(struct node* root, int augmented) {
+    struct node* newRoot = root->right;
+    root->right = newRoot->left;
+    newRoot->left = root;
+    updateHeight(root, augmented);
+    updateHeight(newRoot, augmented);
+    return newRoot;
+}
+struct node* rebalance(struct node* root, int augmented) {
+    updateHeight(root, augmented);
+    int balance = nodeHeight(root->left) - nodeHeight(root->right);
+    if (balance > 1) {
+        if (nodeHeight(root->left->left) < nodeHeight(root->left->right)) {
+            root->left = rotateLeft(root->left, augmented); // Left-right case
+        }
+        return rotateRight(root, augmented);
+    }
+    if (balance < -1) {
+        if (nodeHeight(root->right->right) < nodeHeight(root->right->left)) {
+            root->right = rotateRight(root->right, augmented); // Right-left case
+        }
+        return rotateLeft(root, augmented);
+    }
+    return root;
+}
+int insert(struct tree* tree, int data) {
+    // Iterative, so a degenerate tree cannot overflow the call stack. The links walked
+    // down are kept to fix heights, and rebalance in AVL mode, on the way back up.
+    // Returns 0, leaving the tree unchanged, if memory runs out
+    struct node** localPath[64]; // Enough for any AVL tree; deeper unbalanced trees use the heap
+    struct node*** path = localPath;
+    int pathCapacity = nodeHeight(tree->root) + 1; // The walk visits at most one node per level
+    if (pathCapacity > 64) {
+        path = (struct node***)malloc(pathCapacity * sizeof(struct node**));
+        if (path == NULL) {
+            return 0;
+        }
+    }
+    int pathLength = 0;
+    struct node** link = &tree->root;
+    while (*link != NULL) {
+        path[pathLength++] = link;
+        link = data < (*link)->data ? &(*link)->left : &(*link)->right;
+    }
+    *link = createNode(data);
+    if (*link == NULL) {
+        pathLength = 0; // Nothing was linked, so the tree is as it was
+    }
+    int inserted = *link != NULL;
+    while (pathLength > 0) {
+        link = path[--pathLength];
+        int oldHeight = (*link)->height;
+        if (tree->mode == TREE_AVL) {
+            *link = rebalance(*link, tree->augmented);
+        } else {
+            updateHeight(*link, tree->augmented);
+        }
+        if ((*link)->height == oldHeight && !tree->augmented) {
+            break; // Subtree height unchanged, so nothing above changes either
+        }
+    }
+    if (path != localPath) {
+        free(path);
+    }
+    return inserted;
+}
+// Pull-based traversal with an explicit stack, so a degenerate tree cannot overflow the
+// call stack. Every order keeps at most one root-to-leaf path plus pending right children,
+// which the stored heights bound, so the stack is sized once. Inserting into the tree
+// invalidates its iterators.
+struct treeIterator {
+    struct node* root;
+    enum TraversalOrder order;
+    struct node** stack;
+    int top;
+    struct node* current; // Postorder: subtree still to descend into
+    struct node* last; // Postorder: node returned most recently
+    int peeked; // A key was read ahead by iteratorPeek
+    int peekedKey;
+    int bounded; // Inorder: stop before the first key above high
+    int high;
+};
+void iteratorPushLeft(struct treeIterator* it, struct node* root) {
+    while (root != NULL) {
+        it->stack[it->top++] = root;
+        root = root->left;
+    }
+}
+void iteratorReset(struct treeIterator* it) {
+    it->top = 0;
+    it->current = NULL;
+    it->last = NULL;
+    it->peeked = 0;
+    it->peekedKey = 0;
+    if (it->root == NULL) {
+        return;
+    }
+    if (it->order == ORDER_INORDER) {
+        iteratorPushLeft(it, it->root);
+    } else if (it->order == ORDER_PREORDER) {
+        it->stack[it->top++] = it->root;
     } else {
-        insert(&((*root)->right), data);
+        it->current = it->root;
     }
 }
-void inorder(struct node* root) {
-    if (root != NULL) {
-        inorder(root->left);
-        printf("%d ", root->data);
-        inorder(root->right);
+struct treeIterator* iteratorCreate(struct node* root, enum TraversalOrder order) {
+    struct treeIterator* it = (struct treeIterator*)malloc(sizeof(struct treeIterator));
+    it->root = root;
+    it->order = order;
+    it->bounded = 0;
+    it->high = 0;
+    it->stack = (struct node**)malloc((nodeHeight(root) + 2) * sizeof(struct node*));
+    iteratorReset(it);
+    return it;
+}
+void iteratorFree(struct treeIterator* it) {
+    if (it != NULL) {
+        free(it->stack);
+        free(it);
     }
 }
-void preorder(struct node* root) {
-    if (root != NULL) {
-        printf("%d ", root->data);
-        preorder(root->left);
-        preorder(root->right);
+int iteratorAdvance(struct treeIterator* it, int* key) {
+    struct node* next;
+    if (it->order == ORDER_INORDER) {
+        if (it->top == 0) {
+            return 0;
+        }
+        next = it->stack[--it->top];
+        if (it->bounded && next->data > it->high) {
+            it->top = 0; // Everything left is larger still
+            return 0;
+        }
+        iteratorPushLeft(it, next->right);
+    } else if (it->order == ORDER_PREORDER) {
+        if (it->top == 0) {
+            return 0;
+        }
+        next = it->stack[--it->top];
+        if (next->right != NULL) {
+            it->stack[it->top++] = next->right;
+        }
+        if (next->left != NULL) {
+            it->stack[it->top++] = next->left;
+        }
+    } else {
+        for (;;) {
+            if (it->current != NULL) {
+                iteratorPushLeft(it, it->current);
+                it->current = NULL;
+            }
+            if (it->top == 0) {
+                return 0;
+            }
+            struct node* parent = it->stack[it->top - 1];
+            if (parent->right != NULL && parent->right != it->last) {
+                it->current = parent->right;
+            } else {
+                break;
+            }
+        }
+        next = it->stack[--it->top];
+        it->last = next;
     }
+    *key = next->data;
+    return 1;
 }
-void postorder(struct node* root) {
-    if (root != NULL) {
-        postorder(root->left);
-        postorder(root->right);
-        printf("%d ", root->data);
+int iteratorNext(struct treeIterator* it, int* key) {
+    // Returns 1 and stores the next key, or 0 once the traversal is done
+    if (it->peeked) {
+        it->peeked = 0;
+        *key = it->peekedKey;
+        return 1;
     }
+    return iteratorAdvance(it, key);
 }
-int height(struct node* root) {
-    if (root == NULL) {
-        return -1; // Height of an empty tree is -1
+int iteratorPeek(struct treeIterator* it, int* key) {
+    // Like iteratorNext, but the key is returned again by the following call
+    if (!it->peeked) {
+        it->peeked = iteratorAdvance(it, &it->peekedKey);
+    }
+    if (it->peeked) {
+        *key = it->peekedKey;
+    }
+    return it->peeked;
+}
+int iteratorNextBatch(struct treeIterator* it, int* buffer, int capacity) {
+    // Fills up to capacity keys and returns how many; 0 once the traversal is done
+    int count = 0;
+    while (count < capacity && iteratorNext(it, &buffer[count])) {
+        count++;
+    }
+    return count;
+}
+int iteratorSeek(struct treeIterator* it, int key) {
+    // Inorder only: the next key becomes the smallest one >= key. Rebuilds the stack
+    // along the search path, O(height). Returns 0 for other orders
+    if (it->order != ORDER_INORDER) {
+        return 0;
+    }
+    it->top = 0;
+    it->peeked = 0;
+    struct node* current = it->root;
+    while (current != NULL) {
+        if (current->data >= key) {
+            it->stack[it->top++] = current; // Visited after everything in its left subtree
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+    return 1;
+}
+struct treeIterator* rangeIteratorCreate(struct node* root, int low, int high) {
+    // Inorder over the keys in [low, high]: O(height) to start, then O(1) amortized per key
+    struct treeIterator* it = iteratorCreate(root, ORDER_INORDER);
+    iteratorSeek(it, low);
+    it->bounded = 1;
+    it->high = high;
+    return it;
+}
+void printTraversal(struct node* root, enum TraversalOrder order) {
+    int keys[TRAVERSAL_BATCH];
+    int count;
+    struct treeIterator* it = iteratorCreate(root, order);
+    while ((count = iteratorNextBatch(it, keys, TRAVERSAL_BATCH)) > 0) {
+        for (int i = 0; i < count; i++) {
+            printf("%d ", keys[i]);
+        }
     }
-    int leftHeight = height(root->left);
-    int rightHeight = height(root->right);
-    return (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+    iteratorFree(it);
+}
+void inorder(struct node* root) {
+    printTraversal(root, ORDER_INORDER);
+}
+void preorder(struct node* root) {
+    printTraversal(root, ORDER_PREORDER);
+}
+void postorder(struct node* root) {
+    printTraversal(root, ORDER_POSTORDER);
+}
+int height(struct node* root) {
+    return nodeHeight(root); // Height of an empty tree is -1
 }
 int search(struct node* root, int data) {
+    while (root != NULL) {
+        if (root->data == data) {
+            return 1; // Found
+        }
+        root = data < root->data ? root->left : root->right;
+    }
+    return 0; // Not found
+}
+struct treeMetrics computeMetrics(struct node* root) {
+    // One iterative post-order pass: each node's fields are rebuilt from its children's,
+    // so every node is left current and a degenerate tree cannot overflow the call stack
+    struct treeMetrics metrics = { 0, -1, 0, -1, -1, 0 };
     if (root == NULL) {
-        return 0; // Not found
+        return metrics;
     }
-    if (root->data == data) {
-        return 1; // Found
-    } else if (data < root->data) {
-        return search(root->left, data);
-    } else {
-        return search(root->right, data);
+    int capacity = 64, top = 0;
+    struct node** stack = (struct node**)malloc(capacity * sizeof(struct node*));
+    struct node* current = root;
+    struct node* last = NULL; // Node finished most recently
+    while (current != NULL || top > 0) {
+        if (current != NULL) {
+            if (top == capacity) {
+                capacity *= 2;
+                stack = (struct node**)realloc(stack, capacity * sizeof(struct node*));
+            }
+            stack[top++] = current;
+            current = current->left;
+        } else if (stack[top - 1]->right != NULL && stack[top - 1]->right != last) {
+            current = stack[top - 1]->right;
+        } else {
+            last = stack[--top];
+            updateMetrics(last);
+        }
     }
+    free(stack);
+    metrics.size = root->size;
+    metrics.height = root->height;
+    metrics.diameter = root->diameter;
+    metrics.min = root->min;
+    metrics.max = root->max;
+    metrics.sum = root->sum;
+    return metrics;
 }
-int findMin(struct node* root) {
+void setAugmentedMetrics(struct tree* tree, int enabled) {
+    // The fields went stale while the option was off, so bring them up to date first
+    if (enabled && !tree->augmented) {
+        computeMetrics(tree->root);
+    }
+    tree->augmented = enabled;
+}
+int findMin(struct tree* tree) {
+    struct node* root = tree->root;
     if (root == NULL) {
         return -1; // Tree is empty
     }
+    if (tree->augmented) {
+        return root->min;
+    }
     while (root->left != NULL) {
         root = root->left;
     }
     return root->data;
 }
-int findMax(struct node* root) {
+int findMax(struct tree* tree) {
+    struct node* root = tree->root;
     if (root == NULL) {
         return -1; // Tree is empty
     }
+    if (tree->augmented) {
+        return root->max;
+    }
     while (root->right != NULL) {
         root = root->right;
     }
     return root->data;
 }
-int size(struct node* root) {
-    if (root == NULL) {
+int size(struct tree* tree) {
+    if (tree->root == NULL) {
         return 0; // Size of an empty tree is 0
     }
-    return 1 + size(root->left) + size(root->right);
+    return tree->augmented ? tree->root->size : computeMetrics(tree->root).size;
 }
 int width(struct node* root) {
-    if (root == NULL) {
-        return 0; // Width of an empty tree is 0
-    }
-    int leftWidth = width(root->left);
-    int rightWidth = width(root->right);
-    return 1 + (leftWidth > rightWidth ? leftWidth : rightWidth);
+    return nodeHeight(root) + 1; // Levels in the tree, 0 when empty
 }
 int depth(struct node* root, int data) {
-    if (root == NULL) {
-        return -1; // Data not found
+    // Follows the search path, so the shallowest copy of a duplicate key is the one found
+    int level = 0;
+    while (root != NULL) {
+        if (root->data == data) {
+            return level;
+        }
+        root = data < root->data ? root->left : root->right;
+        level++;
+    }
+    return -1; // Data not found
+}
+int diameter(struct tree* tree) {
+    // Edges on the longest path between two nodes, the same unit as height
+    if (tree->root == NULL) {
+        return 0; // Diameter of an empty tree is 0
     }
-    if (root->data == data) {
-        return 0; // Found at root
+    return tree->augmented ? tree->root->diameter : computeMetrics(tree->root).diameter;
+}
+// Order statistics walk one root-to-leaf path using subtree sizes and sums, O(height).
+// With augmented metrics off the fields are stale, so they first cost one O(n) pass
+int kthSmallest(struct tree* tree, int k) {
+    // k counts from 1; returns -1 when k is out of range, like findMin on an empty tree
+    struct node* root = tree->root;
+    if (!tree->augmented) {
+        computeMetrics(root);
     }
-    int leftDepth = depth(root->left, data);
-    if (leftDepth != -1) {
-        return leftDepth + 1; // Found in left subtree
+    while (root != NULL) {
+        int leftSize = root->left ? root->left->size : 0;
+        if (k <= leftSize) {
+            root = root->left;
+        } else if (k == leftSize + 1) {
+            return root->data;
+        } else {
+            k -= leftSize + 1;
+            root = root->right;
+        }
     }
-    int rightDepth = depth(root->right, data);
-    if (rightDepth != -1) {
-        return rightDepth + 1; // Found in right subtree
+    return -1;
+}
+int countBelow(struct node* root, int key, int inclusive, long long* sum) {
+    // Keys < key, or <= key when inclusive, and their sum. Equal keys can sit on either
+    // side after rotations, but a left subtree never exceeds its node and a right one is
+    // never below it, so one side can always be taken or skipped whole
+    int count = 0;
+    *sum = 0;
+    while (root != NULL) {
+        if (root->data < key || (inclusive && root->data == key)) {
+            count += 1 + (root->left ? root->left->size : 0);
+            *sum += root->data + (root->left ? root->left->sum : 0);
+            root = root->right;
+        } else {
+            root = root->left;
+        }
     }
-    return -1; // Data not found
+    return count;
 }
-int diameter(struct node* root) {
-    if (root == NULL) {
-        return 0; // Diameter of an empty tree is 0
+int rankOf(struct tree* tree, int key) {
+    // Number of keys smaller than key, whether or not key is in the tree
+    long long sum;
+    if (!tree->augmented) {
+        computeMetrics(tree->root);
     }
-    int leftHeight = height(root->left);
-    int rightHeight = height(root->right);
-    int leftDiameter = diameter(root->left);
-    int rightDiameter = diameter(root->right);
-    return (leftHeight + rightHeight + 1 > leftDiameter && leftHeight + rightHeight + 1 > rightDiameter) ? 
-           leftHeight + rightHeight + 1 : 
-           (leftDiameter > rightDiameter ? leftDiameter : rightDiameter);
+    return countBelow(tree->root, key, 0, &sum);
+}
+int countInRange(struct tree* tree, int low, int high, long long* sum) {
+    // Keys in [low, high] and, if sum is not NULL, their total
+    long long lowSum, highSum;
+    if (low > high) {
+        if (sum != NULL) {
+            *sum = 0;
+        }
+        return 0;
+    }
+    if (!tree->augmented) {
+        computeMetrics(tree->root);
+    }
+    int count = countBelow(tree->root, high, 1, &highSum) - countBelow(tree->root, low, 0, &lowSum);
+    if (sum != NULL) {
+        *sum = highSum - lowSum;
+    }
+    return count;
+}
+long long sumInRange(struct tree* tree, int low, int high) {
+    long long sum;
+    countInRange(tree, low, high, &sum);
+    return sum;
 }
 void freeTree(struct node* root) {
-    if (root != NULL) {
-        freeTree(root->left);
-        freeTree(root->right);
-        free(root);
+    // Rotates left children up until the root has none, then frees it and moves right.
+    // Linear time with no stack at all, whatever the shape
+    while (root != NULL) {
+        if (root->left != NULL) {
+            struct node* left = root->left;
+            root->left = left->right;
+            left->right = root;
+            root = left;
+        } else {
+            struct node* right = root->right;
+            free(root);
+            root = right;
+        }
+    }
+}
+// Compact tree: nodes live in large blocks owned by an arena and link to each other by
+// 32-bit index, so a node is 16 bytes instead of a pointer node plus its malloc header,
+// neighbours in insertion order share cache lines and pages, and teardown frees whole
+// blocks. Indices stay valid as the arena grows because blocks are never moved.
+// Balanced like struct tree, by the mode given to arenaCreate; augmented metrics are not kept here.
+struct compactNode {
+    int data;
+    int height; // Same meaning as in struct node
+    unsigned int left; // ARENA_NULL when absent
+    unsigned int right;
+};
+struct nodeArena {
+    struct compactNode** blocks;
+    int blockCount;
+    int blockCapacity;
+    unsigned int count; // Indices handed out so far, counting the reserved 0
+    unsigned int root;
+    enum TreeMode mode;
+    unsigned int* path; // Scratch for arenaInsert
+    int pathCapacity;
+};
+struct nodeArena* arenaCreate(enum TreeMode mode) {
+    struct nodeArena* arena = (struct nodeArena*)calloc(1, sizeof(struct nodeArena));
+    arena->mode = mode;
+    arena->count = 1; // Reserve ARENA_NULL
+    arena->root = ARENA_NULL;
+    return arena;
+}
+void arenaFree(struct nodeArena* arena) {
+    if (arena == NULL) {
+        return;
+    }
+    for (int i = 0; i < arena->blockCount; i++) {
+        free(arena->blocks[i]);
+    }
+    free(arena->blocks);
+    free(arena->path);
+    free(arena);
+}
+struct compactNode* arenaNode(struct nodeArena* arena, unsigned int index) {
+    return &arena->blocks[index >> ARENA_BLOCK_SHIFT][index & (ARENA_BLOCK_NODES - 1)];
+}
+unsigned int arenaAllocate(struct nodeArena* arena, int data) {
+    // Returns ARENA_NULL once the 32-bit index space or memory runs out
+    unsigned int index = arena->count;
+    if (index == 0xFFFFFFFFu) {
+        return ARENA_NULL;
+    }
+    if ((index >> ARENA_BLOCK_SHIFT) == (unsigned int)arena->blockCount) {
+        if (arena->blockCount == arena->blockCapacity) {
+            int capacity = arena->blockCapacity ? arena->blockCapacity * 2 : 16;
+            struct compactNode** blocks = (struct compactNode**)realloc(arena->blocks, capacity * sizeof(struct compactNode*));
+            if (blocks == NULL) {
+                return ARENA_NULL;
+            }
+            arena->blocks = blocks;
+            arena->blockCapacity = capacity;
+        }
+        struct compactNode* block = (struct compactNode*)malloc(ARENA_BLOCK_NODES * sizeof(struct compactNode));
+        if (block == NULL) {
+            return ARENA_NULL;
+        }
+        arena->blocks[arena->blockCount++] = block;
     }
+    struct compactNode* node = arenaNode(arena, index);
+    node->data = data;
+    node->height = 0;
+    node->left = ARENA_NULL;
+    node->right = ARENA_NULL;
+    arena->count++;
+    return index;
+}
+int arenaHeight(struct nodeArena* arena, unsigned int index) {
+    return index == ARENA_NULL ? -1 : arenaNode(arena, index)->height;
+}
+void arenaUpdateHeight(struct nodeArena* arena, unsigned int index) {
+    struct compactNode* node = arenaNode(arena, index);
+    int leftHeight = arenaHeight(arena, node->left);
+    int rightHeight = arenaHeight(arena, node->right);
+    node->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+}
+unsigned int arenaRotateRight(struct nodeArena* arena, unsigned int root) {
+    unsigned int newRoot = arenaNode(arena, root)->left;
+    arenaNode(arena, root)->left = arenaNode(arena, newRoot)->right;
+    arenaNode(arena, newRoot)->right = root;
+    arenaUpdateHeight(arena, root);
+    arenaUpdateHeight(arena, newRoot);
+    return newRoot;
+}
+unsigned int arenaRotateLeft(struct nodeArena* arena, unsigned int root) {
+    unsigned int newRoot = arenaNode(arena, root)->right;
+    arenaNode(arena, root)->right = arenaNode(arena, newRoot)->left;
+    arenaNode(arena, newRoot)->left = root;
+    arenaUpdateHeight(arena, root);
+    arenaUpdateHeight(arena, newRoot);
+    return newRoot;
+}
+unsigned int arenaRebalance(struct nodeArena* arena, unsigned int root) {
+    arenaUpdateHeight(arena, root);
+    struct compactNode* node = arenaNode(arena, root);
+    int balance = arenaHeight(arena, node->left) - arenaHeight(arena, node->right);
+    if (balance > 1) {
+        struct compactNode* left = arenaNode(arena, node->left);
+        if (arenaHeight(arena, left->left) < arenaHeight(arena, left->right)) {
+            node->left = arenaRotateLeft(arena, node->left); // Left-right case
+        }
+        return arenaRotateRight(arena, root);
+    }
+    if (balance < -1) {
+        struct compactNode* right = arenaNode(arena, node->right);
+        if (arenaHeight(arena, right->right) < arenaHeight(arena, right->left)) {
+            node->right = arenaRotateRight(arena, node->right); // Right-left case
+        }
+        return arenaRotateLeft(arena, root);
+    }
+    return root;
+}
+int arenaInsert(struct nodeArena* arena, int data) {
+    // Same walk as insert; returns 0 if the arena could not grow
+    unsigned int added = arenaAllocate(arena, data);
+    if (added == ARENA_NULL) {
+        return 0;
+    }
+    int pathLength = 0;
+    unsigned int current = arena->root;
+    while (current != ARENA_NULL) {
+        if (pathLength == arena->pathCapacity) {
+            arena->pathCapacity = arena->pathCapacity ? arena->pathCapacity * 2 : 64;
+            arena->path = (unsigned int*)realloc(arena->path, arena->pathCapacity * sizeof(unsigned int));
+        }
+        arena->path[pathLength++] = current;
+        struct compactNode* node = arenaNode(arena, current);
+        current = data < node->data ? node->left : node->right;
+    }
+    if (pathLength == 0) {
+        arena->root = added;
+        return 1;
+    }
+    struct compactNode* parent = arenaNode(arena, arena->path[pathLength - 1]);
+    if (data < parent->data) {
+        parent->left = added;
+    } else {
+        parent->right = added;
+    }
+    while (pathLength > 0) {
+        unsigned int old = arena->path[--pathLength];
+        int oldHeight = arenaNode(arena, old)->height;
+        unsigned int subtree = old;
+        if (arena->mode == TREE_AVL) {
+            subtree = arenaRebalance(arena, old);
+        } else {
+            arenaUpdateHeight(arena, old);
+        }
+        if (subtree != old) {
+            // A rotation put another node at the top of this subtree, relink it
+            if (pathLength == 0) {
+                arena->root = subtree;
+            } else if (arenaNode(arena, arena->path[pathLength - 1])->left == old) {
+                arenaNode(arena, arena->path[pathLength - 1])->left = subtree;
+            } else {
+                arenaNode(arena, arena->path[pathLength - 1])->right = subtree;
+            }
+        }
+        if (arenaNode(arena, subtree)->height == oldHeight) {
+            break; // Subtree height unchanged, so nothing above changes either
+        }
+    }
+    return 1;
+}
+int arenaSearch(struct nodeArena* arena, int data) {
+    unsigned int current = arena->root;
+    while (current != ARENA_NULL) {
+        struct compactNode* node = arenaNode(arena, current);
+        if (node->data == data) {
+            return 1; // Found
+        }
+        current = data < node->data ? node->left : node->right;
+    }
+    return 0; // Not found
+}
+long long arenaBytes(struct nodeArena* arena) {
+    return (long long)arena->blockCount * ARENA_BLOCK_NODES * sizeof(struct compactNode) +
+           arena->blockCapacity * sizeof(struct compactNode*);
+}
+// Frozen tree: a read-only copy of a tree's keys in Eytzinger (BFS) order, where the
+// children of keys[k] are keys[2k] and keys[2k + 1]. Search is a fixed sequence of
+// compares with no pointers and no hard-to-predict branches, and the top of the tree
+// shares a few cache lines. Rebuild it with freezeTree after the tree changes.
+struct frozenTree {
+    int* keys; // 1-based and cache-line aligned; keys[0] is unused
+    int count;
+    int depth; // Of the deepest level, 0 for a single key
+};
+int countTrailingZeros(unsigned int mask) {
+#ifdef __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int n = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+struct frozenTree* freezeTree(struct tree* tree) {
+    struct frozenTree* frozen = (struct frozenTree*)malloc(sizeof(struct frozenTree));
+    frozen->count = size(tree);
+    frozen->depth = 0;
+    while ((2LL << frozen->depth) <= frozen->count) {
+        frozen->depth++;
+    }
+    // Pad to whole cache lines, aligned_alloc needs a multiple of the alignment
+    size_t bytes = ((size_t)(frozen->count + 1) * sizeof(int) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    frozen->keys = (int*)aligned_alloc(CACHE_LINE_SIZE, bytes);
+    // Walk the implicit tree in order while the iterator yields keys in order; k starts
+    // at the leftmost slot and moves to its inorder successor each time
+    struct treeIterator* it = iteratorCreate(tree->root, ORDER_INORDER);
+    unsigned int n = (unsigned int)frozen->count;
+    unsigned int k = 1;
+    while (2 * k <= n) {
+        k *= 2;
+    }
+    int key;
+    while (iteratorNext(it, &key)) {
+        frozen->keys[k] = key;
+        if (2 * k + 1 <= n) {
+            k = 2 * k + 1;
+            while (2 * k <= n) {
+                k *= 2;
+            }
+        } else {
+            k >>= countTrailingZeros(~k) + 1; // Up past every step taken as a right child, then once more
+        }
+    }
+    iteratorFree(it);
+    return frozen;
+}
+void frozenFree(struct frozenTree* frozen) {
+    if (frozen != NULL) {
+        free(frozen->keys);
+        free(frozen);
+    }
+}
+unsigned int frozenLowerBound(struct frozenTree* frozen, int key) {
+    // Slot of the smallest key >= key, 0 if there is none. The loop always runs depth + 1
+    // or depth + 2 times and only the slot arithmetic depends on the compare
+    unsigned int n = (unsigned int)frozen->count;
+    unsigned int k = 1;
+    while (k <= n) {
+        PREFETCH(frozen->keys + ((size_t)k << FROZEN_PREFETCH_LEVELS)); // Hint only, may point past the end
+        k = 2 * k + (frozen->keys[k] < key);
+    }
+    // Every step after the answer went right; undo them and the left step into the answer
+    return k >> (countTrailingZeros(~k) + 1);
+}
+int frozenSearch(struct frozenTree* frozen, int key) {
+    unsigned int k = frozenLowerBound(frozen, key);
+    return k != 0 && frozen->keys[k] == key;
+}
+int frozenMin(struct frozenTree* frozen) {
+    if (frozen->count == 0) {
+        return -1; // Tree is empty
+    }
+    unsigned int k = 1;
+    while (2 * k <= (unsigned int)frozen->count) {
+        k *= 2;
+    }
+    return frozen->keys[k];
+}
+int frozenMax(struct frozenTree* frozen) {
+    if (frozen->count == 0) {
+        return -1; // Tree is empty
+    }
+    unsigned int k = 1;
+    while (2 * k + 1 <= (unsigned int)frozen->count) {
+        k = 2 * k + 1;
+    }
+    return frozen->keys[k];
+}
+int frozenSubtreeSize(struct frozenTree* frozen, unsigned int k, int level) {
+    // Nodes under slot k at the given level: every level above the last is full,
+    // and the last one is filled from the left
+    if (level > frozen->depth) {
+        return 0;
+    }
+    int below = frozen->depth - level;
+    long long firstLast = (long long)k << below; // Leftmost slot on the last level
+    long long lastCount = frozen->count - firstLast + 1;
+    if (lastCount < 0) {
+        lastCount = 0;
+    } else if (lastCount > (1LL << below)) {
+        lastCount = 1LL << below;
+    }
+    return (int)((1LL << below) - 1 + lastCount);
+}
+int frozenRank(struct frozenTree* frozen, int key) {
+    // Number of keys < key: each step right skips the node and its left subtree
+    unsigned int n = (unsigned int)frozen->count;
+    unsigned int k = 1;
+    int level = 0, rank = 0;
+    while (k <= n) {
+        PREFETCH(frozen->keys + ((size_t)k << FROZEN_PREFETCH_LEVELS));
+        int right = frozen->keys[k] < key;
+        rank += right * (frozenSubtreeSize(frozen, 2 * k, level + 1) + 1);
+        k = 2 * k + right;
+        level++;
+    }
+    return rank;
+}
+// B+ tree: keys live in the leaves, which are linked in order for range scans; inner
+// nodes only route. Each key is stored once, unlike insert above, which keeps duplicates
+struct bplusLeaf {
+    int count;
+    int keys[BPLUS_LEAF_KEYS];
+    struct bplusLeaf* next;
+};
+struct bplusInner {
+    int count; // Keys in use, children in use is one more
+    int keys[BPLUS_INNER_KEYS]; // keys[i] is at most the smallest key under children[i + 1]
+    void* children[BPLUS_INNER_KEYS + 1]; // Leaves one level above the leaves, inner nodes elsewhere
+};
+struct bplusTree {
+    void* root; // A leaf when height is 0
+    int height; // Inner levels above the leaves
+    struct bplusLeaf* first; // Leftmost leaf, never freed while the tree lives
+    long long count;
+};
+int lowerBound(const int* keys, int count, int key) {
+    // Branchless binary search: the loop runs a fixed log2(count) times and the
+    // comparison becomes a conditional move instead of a hard-to-predict branch
+    if (count == 0) {
+        return 0;
+    }
+    const int* base = keys;
+    while (count > 1) {
+        int half = count / 2;
+        base = base[half] < key ? base + half : base;
+        count -= half;
+    }
+    return (int)(base - keys) + (*base < key);
+}
+int upperBound(const int* keys, int count, int key) {
+    if (count == 0) {
+        return 0;
+    }
+    const int* base = keys;
+    while (count > 1) {
+        int half = count / 2;
+        base = base[half] <= key ? base + half : base;
+        count -= half;
+    }
+    return (int)(base - keys) + (*base <= key);
+}
+struct bplusTree* bplusCreate(void) {
+    struct bplusTree* tree = (struct bplusTree*)malloc(sizeof(struct bplusTree));
+    tree->first = (struct bplusLeaf*)calloc(1, sizeof(struct bplusLeaf));
+    tree->root = tree->first;
+    tree->height = 0;
+    tree->count = 0;
+    return tree;
+}
+void bplusFreeNode(void* node, int level) {
+    if (level > 0) {
+        struct bplusInner* inner = (struct bplusInner*)node;
+        for (int i = 0; i <= inner->count; i++) {
+            bplusFreeNode(inner->children[i], level - 1);
+        }
+    }
+    free(node);
+}
+void bplusFree(struct bplusTree* tree) {
+    if (tree != NULL) {
+        bplusFreeNode(tree->root, tree->height);
+        free(tree);
+    }
+}
+void prefetchNode(const void* node, int bytes) {
+    // All lines at once, instead of the binary search missing on them one after another
+    for (int offset = 0; offset < bytes; offset += CACHE_LINE_SIZE) {
+        PREFETCH((const char*)node + offset);
+    }
+}
+struct bplusLeaf* bplusFindLeaf(struct bplusTree* tree, int key) {
+    void* node = tree->root;
+    for (int level = tree->height; level > 0; level--) {
+        struct bplusInner* inner = (struct bplusInner*)node;
+        node = inner->children[upperBound(inner->keys, inner->count, key)];
+        prefetchNode(node, level > 1 ? (int)sizeof(struct bplusInner) : (int)sizeof(struct bplusLeaf));
+    }
+    return (struct bplusLeaf*)node;
+}
+int bplusSearch(struct bplusTree* tree, int key) {
+    struct bplusLeaf* leaf = bplusFindLeaf(tree, key);
+    int position = lowerBound(leaf->keys, leaf->count, key);
+    return position < leaf->count && leaf->keys[position] == key; // 1 if found
+}
+void* bplusInsertInto(void* node, int level, int key, int* separator, int* inserted) {
+    // Returns the new right sibling if node had to split, with its smallest key in *separator
+    if (level == 0) {
+        struct bplusLeaf* leaf = (struct bplusLeaf*)node;
+        int position = lowerBound(leaf->keys, leaf->count, key);
+        if (position < leaf->count && leaf->keys[position] == key) {
+            return NULL; // Already present
+        }
+        *inserted = 1;
+        struct bplusLeaf* right = NULL;
+        if (leaf->count == BPLUS_LEAF_KEYS) {
+            int half = (BPLUS_LEAF_KEYS + 1) / 2;
+            right = (struct bplusLeaf*)malloc(sizeof(struct bplusLeaf));
+            right->count = leaf->count - half;
+            memcpy(right->keys, leaf->keys + half, right->count * sizeof(int));
+            right->next = leaf->next;
+            leaf->next = right;
+            leaf->count = half;
+            if (position > half) {
+                leaf = right;
+                position -= half;
+            }
+        }
+        memmove(leaf->keys + position + 1, leaf->keys + position, (leaf->count - position) * sizeof(int));
+        leaf->keys[position] = key;
+        leaf->count++;
+        if (right != NULL) {
+            *separator = right->keys[0];
+        }
+        return right;
+    }
+    
+    struct bplusInner* inner = (struct bplusInner*)node;
+    int index = upperBound(inner->keys, inner->count, key);
+    int childSeparator;
+    void* newChild = bplusInsertInto(inner->children[index], level - 1, key, &childSeparator, inserted);
+    if (newChild == NULL) {
+        return NULL;
+    }
+    if (inner->count < BPLUS_INNER_KEYS) {
+        memmove(inner->keys + index + 1, inner->keys + index, (inner->count - index) * sizeof(int));
+        memmove(inner->children + index + 2, inner->children + index + 1, (inner->count - index) * sizeof(void*));
+        inner->keys[index] = childSeparator;
+        inner->children[index + 1] = newChild;
+        inner->count++;
+        return NULL;
+    }
+    
+    // Full: lay out all keys and children with the new pair, then move the middle key up
+    int keys[BPLUS_INNER_KEYS + 1];
+    void* children[BPLUS_INNER_KEYS + 2];
+    memcpy(keys, inner->keys, index * sizeof(int));
+    keys[index] = childSeparator;
+    memcpy(keys + index + 1, inner->keys + index, (BPLUS_INNER_KEYS - index) * sizeof(int));
+    memcpy(children, inner->children, (index + 1) * sizeof(void*));
+    children[index + 1] = newChild;
+    memcpy(children + index + 2, inner->children + index + 1, (BPLUS_INNER_KEYS - index) * sizeof(void*));
+    
+    int half = (BPLUS_INNER_KEYS + 1) / 2;
+    struct bplusInner* right = (struct bplusInner*)malloc(sizeof(struct bplusInner));
+    inner->count = half;
+    memcpy(inner->keys, keys, half * sizeof(int));
+    memcpy(inner->children, children, (half + 1) * sizeof(void*));
+    *separator = keys[half];
+    right->count = BPLUS_INNER_KEYS - half;
+    memcpy(right->keys, keys + half + 1, right->count * sizeof(int));
+    memcpy(right->children, children + half + 1, (right->count + 1) * sizeof(void*));
+    return right;
+}
+int bplusInsert(struct bplusTree* tree, int key) {
+    int separator, inserted = 0;
+    void* right = bplusInsertInto(tree->root, tree->height, key, &separator, &inserted);
+    if (right != NULL) {
+        struct bplusInner* root = (struct bplusInner*)malloc(sizeof(struct bplusInner));
+        root->count = 1;
+        root->keys[0] = separator;
+        root->children[0] = tree->root;
+        root->children[1] = right;
+        tree->root = root;
+        tree->height++;
+    }
+    tree->count += inserted;
+    return inserted; // 0 if the key was already present
+}
+void bplusFixChild(struct bplusInner* parent, int index, int level) {
+    // children[index] (at level) fell below half full: borrow a key from a sibling
+    // with keys to spare, or else merge it with one, always into the left node
+    if (level == 0) {
+        struct bplusLeaf* child = (struct bplusLeaf*)parent->children[index];
+        struct bplusLeaf* left = index > 0 ? (struct bplusLeaf*)parent->children[index - 1] : NULL;
+        struct bplusLeaf* right = index < parent->count ? (struct bplusLeaf*)parent->children[index + 1] : NULL;
+        if (left != NULL && left->count > BPLUS_LEAF_KEYS / 2) {
+            memmove(child->keys + 1, child->keys, child->count * sizeof(int));
+            child->keys[0] = left->keys[--left->count];
+            child->count++;
+            parent->keys[index - 1] = child->keys[0];
+            return;
+        }
+        if (right != NULL && right->count > BPLUS_LEAF_KEYS / 2) {
+            child->keys[child->count++] = right->keys[0];
+            memmove(right->keys, right->keys + 1, --right->count * sizeof(int));
+            parent->keys[index] = right->keys[0];
+            return;
+        }
+        if (left != NULL) {
+            right = child;
+            child = left;
+            index--;
+        }
+        memcpy(child->keys + child->count, right->keys, right->count * sizeof(int));
+        child->count += right->count;
+        child->next = right->next;
+        free(right);
+    } else {
+        struct bplusInner* child = (struct bplusInner*)parent->children[index];
+        struct bplusInner* left = index > 0 ? (struct bplusInner*)parent->children[index - 1] : NULL;
+        struct bplusInner* right = index < parent->count ? (struct bplusInner*)parent->children[index + 1] : NULL;
+        if (left != NULL && left->count > BPLUS_INNER_KEYS / 2) {
+            memmove(child->keys + 1, child->keys, child->count * sizeof(int));
+            memmove(child->children + 1, child->children, (child->count + 1) * sizeof(void*));
+            child->keys[0] = parent->keys[index - 1];
+            child->children[0] = left->children[left->count];
+            child->count++;
+            parent->keys[index - 1] = left->keys[--left->count];
+            return;
+        }
+        if (right != NULL && right->count > BPLUS_INNER_KEYS / 2) {
+            child->keys[child->count] = parent->keys[index];
+            child->children[child->count + 1] = right->children[0];
+            child->count++;
+            parent->keys[index] = right->keys[0];
+            right->count--;
+            memmove(right->keys, right->keys + 1, right->count * sizeof(int));
+            memmove(right->children, right->children + 1, (right->count + 1) * sizeof(void*));
+            return;
+        }
+        if (left != NULL) {
+            right = child;
+            child = left;
+            index--;
+        }
+        child->keys[child->count] = parent->keys[index];
+        memcpy(child->keys + child->count + 1, right->keys, right->count * sizeof(int));
+        memcpy(child->children + child->count + 1, right->children, (right->count + 1) * sizeof(void*));
+        child->count += right->count + 1;
+        free(right);
+    }
+    // The right node of the merge is gone, along with the key separating it
+    memmove(parent->keys + index, parent->keys + index + 1, (parent->count - index - 1) * sizeof(int));
+    memmove(parent->children + index + 1, parent->children + index + 2, (parent->count - index - 1) * sizeof(void*));
+    parent->count--;
+}
+int bplusDeleteFrom(void* node, int level, int key) {
+    if (level == 0) {
+        struct bplusLeaf* leaf = (struct bplusLeaf*)node;
+        int position = lowerBound(leaf->keys, leaf->count, key);
+        if (position == leaf->count || leaf->keys[position] != key) {
+            return 0; // Not found
+        }
+        memmove(leaf->keys + position, leaf->keys + position + 1, (leaf->count - position - 1) * sizeof(int));
+        leaf->count--;
+        return 1;
+    }
+    // A separator may outlive its key; it still splits the two subtrees correctly
+    struct bplusInner* inner = (struct bplusInner*)node;
+    int index = upperBound(inner->keys, inner->count, key);
+    if (!bplusDeleteFrom(inner->children[index], level - 1, key)) {
+        return 0;
+    }
+    int childCount = *(int*)inner->children[index]; // count is the first field of both node types
+    if (childCount < (level == 1 ? BPLUS_LEAF_KEYS : BPLUS_INNER_KEYS) / 2) {
+        bplusFixChild(inner, index, level - 1);
+    }
+    return 1;
+}
+int bplusDelete(struct bplusTree* tree, int key) {
+    if (!bplusDeleteFrom(tree->root, tree->height, key)) {
+        return 0; // Not found
+    }
+    tree->count--;
+    if (tree->height > 0 && ((struct bplusInner*)tree->root)->count == 0) {
+        void* oldRoot = tree->root;
+        tree->root = ((struct bplusInner*)oldRoot)->children[0];
+        tree->height--;
+        free(oldRoot);
+    }
+    return 1;
+}
+int bplusMin(struct bplusTree* tree) {
+    return tree->count == 0 ? -1 : tree->first->keys[0]; // -1 if the tree is empty
+}
+int bplusMax(struct bplusTree* tree) {
+    if (tree->count == 0) {
+        return -1; // Tree is empty
+    }
+    void* node = tree->root;
+    for (int level = tree->height; level > 0; level--) {
+        struct bplusInner* inner = (struct bplusInner*)node;
+        node = inner->children[inner->count];
+    }
+    struct bplusLeaf* leaf = (struct bplusLeaf*)node;
+    return leaf->keys[leaf->count - 1];
+}
+long long bplusBytes(void* node, int level) {
+    if (level == 0) {
+        return sizeof(struct bplusLeaf);
+    }
+    struct bplusInner* inner = (struct bplusInner*)node;
+    long long bytes = sizeof(struct bplusInner);
+    for (int i = 0; i <= inner->count; i++) {
+        bytes += bplusBytes(inner->children[i], level - 1);
+    }
+    return bytes;
+}
+int bplusRange(struct bplusTree* tree, int low, int high, int* buffer, int capacity) {
+    // Copies the keys in [low, high] into buffer in order, at most capacity of them
+    struct bplusLeaf* leaf = bplusFindLeaf(tree, low);
+    int position = lowerBound(leaf->keys, leaf->count, low);
+    int copied = 0;
+    while (leaf != NULL && copied < capacity) {
+        for (; position < leaf->count && copied < capacity; position++) {
+            if (leaf->keys[position] > high) {
+                return copied;
+            }
+            buffer[copied++] = leaf->keys[position];
+        }
+        leaf = leaf->next;
+        position = 0;
+    }
+    return copied;
+}
+long long nowNanoseconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+unsigned long long nextRandom(unsigned long long* state) {
+    // splitmix64: rand() only gives 15 bits on some platforms
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+void benchmarkBalancing(int count) {
+    const char* orders[] = { "sorted", "reverse", "random" };
+    const char* modes[] = { "unbalanced", "AVL" };
+    const int unbalancedLimit = 20000; // Sorted input costs O(n^2) without balancing
+    const int lookups = 1000000;
+    int* keys = (int*)malloc(count * sizeof(int));
+    unsigned long long seed = 42;
+    printf("%-8s %-11s %10s %8s %12s %12s\n", "order", "mode", "keys", "height", "insert(M/s)", "search(M/s)");
+    for (int order = 0; order < 3; order++) {
+        for (int i = 0; i < count; i++) {
+            keys[i] = order == 1 ? count - 1 - i : i;
+        }
+        if (order == 2) {
+            for (int i = count - 1; i > 0; i--) {
+                int j = (int)(nextRandom(&seed) % (i + 1));
+                int temp = keys[i];
+                keys[i] = keys[j];
+                keys[j] = temp;
+            }
+        }
+        for (int mode = TREE_UNBALANCED; mode <= TREE_AVL; mode++) {
+            int n = mode == TREE_UNBALANCED && order != 2 && count > unbalancedLimit ? unbalancedLimit : count;
+            struct tree tree = { NULL, (enum TreeMode)mode, 0 };
+            long long start = nowNanoseconds();
+            for (int i = 0; i < n; i++) {
+                insert(&tree, keys[i]);
+            }
+            long long insertTime = nowNanoseconds() - start;
+            long long found = 0;
+            start = nowNanoseconds();
+            for (int i = 0; i < lookups; i++) {
+                found += search(tree.root, keys[nextRandom(&seed) % n]);
+            }
+            long long searchTime = nowNanoseconds() - start;
+            printf("%-8s %-11s %10d %8d %12.2f %12.2f\n", orders[order], modes[mode], n, height(tree.root),
+                   n * 1000.0 / insertTime, lookups * 1000.0 / searchTime);
+            if (found != lookups) {
+                printf("%lld of %d lookups missed\n", lookups - found, lookups);
+            }
+            freeTree(tree.root);
+        }
+    }
+    printf("Unbalanced sorted and reverse runs stop at %d keys\n", unbalancedLimit);
+    free(keys);
+}
+void benchmarkBPlusTree(int maxCount) {
+    // Same random keys in an AVL tree and a B+ tree at each size, from 1M up to maxCount
+    const int lookups = 1000000;
+    const int scanLength = 1000;
+    int* keys = (int*)malloc(maxCount * sizeof(int));
+    int* buffer = (int*)malloc(scanLength * sizeof(int));
+    unsigned long long seed = 7;
+    printf("%10s %-6s %7s %10s %12s %12s %12s\n", "keys", "tree", "height", "bytes/key", "insert(M/s)", "search(M/s)", "scan(Mkeys/s)");
+    for (int count = maxCount < 1000000 ? maxCount : 1000000; ; count = count * 10 < maxCount ? count * 10 : maxCount) {
+        for (int i = 0; i < count; i++) {
+            keys[i] = i * 2; // Odd numbers stay free for misses
+        }
+        for (int i = count - 1; i > 0; i--) {
+            int j = (int)(nextRandom(&seed) % (i + 1));
+            int temp = keys[i];
+            keys[i] = keys[j];
+            keys[j] = temp;
+        }
+        
+        struct tree avl = { NULL, TREE_AVL, 0 };
+        long long start = nowNanoseconds();
+        for (int i = 0; i < count; i++) {
+            insert(&avl, keys[i]);
+        }
+        long long insertTime = nowNanoseconds() - start;
+        long long found = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups; i++) {
+            found += search(avl.root, keys[nextRandom(&seed) % count]);
+        }
+        long long searchTime = nowNanoseconds() - start;
+        printf("%10d %-6s %7d %10d %12.2f %12.2f %12s\n", count, "AVL", height(avl.root), (int)sizeof(struct node),
+               count * 1000.0 / insertTime, lookups * 1000.0 / searchTime, "-");
+        freeTree(avl.root);
+        
+        struct bplusTree* tree = bplusCreate();
+        start = nowNanoseconds();
+        for (int i = 0; i < count; i++) {
+            bplusInsert(tree, keys[i]);
+        }
+        insertTime = nowNanoseconds() - start;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups; i++) {
+            found += bplusSearch(tree, keys[nextRandom(&seed) % count]);
+        }
+        searchTime = nowNanoseconds() - start;
+        long long scanned = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups / scanLength; i++) {
+            int low = keys[nextRandom(&seed) % count];
+            scanned += bplusRange(tree, low, low + scanLength * 2, buffer, scanLength);
+        }
+        long long scanTime = nowNanoseconds() - start;
+        printf("%10d %-6s %7d %10.2f %12.2f %12.2f %12.2f\n", count, "B+", tree->height + 1,
+               (double)bplusBytes(tree->root, tree->height) / count, count * 1000.0 / insertTime,
+               lookups * 1000.0 / searchTime, scanned * 1000.0 / scanTime);
+        if (found != 2LL * lookups) {
+            printf("%lld of %d lookups missed\n", 2LL * lookups - found, 2 * lookups);
+        }
+        bplusFree(tree);
+        if (count == maxCount) {
+            break;
+        }
+    }
+    free(buffer);
+    free(keys);
+}
+void benchmarkMetrics(int count) {
+    // Cost of keeping metrics on every node during inserts, against one fused pass on demand
+    const int queries = 1000000;
+    int* keys = (int*)malloc(count * sizeof(int));
+    unsigned long long seed = 11;
+    for (int i = 0; i < count; i++) {
+        keys[i] = (int)(nextRandom(&seed) >> 33);
+    }
+    printf("%-10s %-11s %10s %12s %14s %14s\n", "metrics", "mode", "keys", "insert(M/s)", "one pass(ms)", "query(ns)");
+    for (int mode = TREE_UNBALANCED; mode <= TREE_AVL; mode++) {
+        for (int augmented = 0; augmented <= 1; augmented++) {
+            struct tree tree = { NULL, (enum TreeMode)mode, augmented };
+            long long start = nowNanoseconds();
+            for (int i = 0; i < count; i++) {
+                insert(&tree, keys[i]);
+            }
+            long long insertTime = nowNanoseconds() - start;
+            start = nowNanoseconds();
+            struct treeMetrics metrics = computeMetrics(tree.root);
+            long long passTime = nowNanoseconds() - start;
+            // Each query asks for all four metrics; without augmentation that is a pass apiece
+            int rounds = augmented ? queries : 3;
+            long long checksum = 0;
+            start = nowNanoseconds();
+            for (int i = 0; i < rounds; i++) {
+                checksum += size(&tree) + diameter(&tree) + findMin(&tree) + findMax(&tree);
+            }
+            long long queryTime = nowNanoseconds() - start;
+            if (checksum != (long long)rounds * (metrics.size + metrics.diameter + metrics.min + metrics.max)) {
+                printf("Metrics disagree with the one-pass result\n");
+            }
+            printf("%-10s %-11s %10d %12.2f %14.2f %14.1f\n", augmented ? "kept" : "on demand",
+                   mode == TREE_AVL ? "AVL" : "unbalanced", count, count * 1000.0 / insertTime,
+                   passTime / 1e6, (double)queryTime / rounds);
+            freeTree(tree.root);
+        }
+    }
+    free(keys);
+}
+void benchmarkTraversal(int count) {
+    // Streams every key of a random tree through the iterator, one at a time and in batches
+    const char* orderNames[] = { "inorder", "preorder", "postorder" };
+    const int seeks = 1000000;
+    int* buffer = (int*)malloc(TRAVERSAL_BATCH * sizeof(int));
+    unsigned long long seed = 13;
+    printf("%-11s %-10s %10s %7s %14s %14s %10s\n", "mode", "order", "keys", "height", "next(Mkeys/s)", "batch(Mkeys/s)", "seek(ns)");
+    for (int mode = TREE_UNBALANCED; mode <= TREE_AVL; mode++) {
+        struct tree tree = { NULL, (enum TreeMode)mode, 0 };
+        long long expected = 0;
+        for (int i = 0; i < count; i++) {
+            int key = (int)(nextRandom(&seed) >> 33);
+            insert(&tree, key);
+            expected += key;
+        }
+        for (int order = ORDER_INORDER; order <= ORDER_POSTORDER; order++) {
+            struct treeIterator* it = iteratorCreate(tree.root, (enum TraversalOrder)order);
+            long long sum = 0;
+            int key, batch;
+            long long start = nowNanoseconds();
+            while (iteratorNext(it, &key)) {
+                sum += key;
+            }
+            long long nextTime = nowNanoseconds() - start;
+            iteratorReset(it);
+            start = nowNanoseconds();
+            while ((batch = iteratorNextBatch(it, buffer, TRAVERSAL_BATCH)) > 0) {
+                for (int i = 0; i < batch; i++) {
+                    sum += buffer[i];
+                }
+            }
+            long long batchTime = nowNanoseconds() - start;
+            if (sum != 2 * expected) {
+                printf("%s traversal lost keys\n", orderNames[order]);
+            }
+            char seekTime[16] = "-";
+            if (order == ORDER_INORDER) {
+                long long misses = 0;
+                start = nowNanoseconds();
+                for (int i = 0; i < seeks; i++) {
+                    iteratorSeek(it, (int)(nextRandom(&seed) >> 33));
+                    misses += !iteratorPeek(it, &key); // Past the largest key
+                }
+                snprintf(seekTime, sizeof(seekTime), "%.1f", (double)(nowNanoseconds() - start) / seeks);
+                if (misses == seeks) {
+                    printf("Every seek ran past the end\n");
+                }
+            }
+            printf("%-11s %-10s %10d %7d %14.2f %14.2f %10s\n", mode == TREE_AVL ? "AVL" : "unbalanced",
+                   orderNames[order], count, height(tree.root), count * 1000.0 / nextTime,
+                   count * 1000.0 / batchTime, seekTime);
+            iteratorFree(it);
+        }
+        freeTree(tree.root);
+    }
+    free(buffer);
+}
+void benchmarkArena(int maxCount) {
+    // Pointer nodes against arena nodes holding the same random keys, AVL balanced,
+    // at 1M and every tenfold size up to maxCount
+    const int lookups = 1000000;
+    const int pointerLimit = 20000000; // About 1 GB of pointer nodes; larger runs measure the arena only
+    // A malloc'd node also pays a size header and rounding to 16 bytes (glibc)
+    const int pointerBytes = (int)((sizeof(struct node) + sizeof(size_t) + 15) & ~(size_t)15);
+    int* keys = (int*)malloc(maxCount * sizeof(int));
+    unsigned long long seed = 17;
+    printf("%10s %-8s %7s %10s %12s %12s %10s\n", "keys", "nodes", "height", "bytes/key", "insert(M/s)", "search(M/s)", "free(ms)");
+    for (int count = maxCount < 1000000 ? maxCount : 1000000; ; count = count < maxCount / 10 ? count * 10 : maxCount) {
+        for (int i = 0; i < count; i++) {
+            keys[i] = (int)(nextRandom(&seed) >> 33);
+        }
+        
+        struct nodeArena* arena = arenaCreate(TREE_AVL);
+        long long start = nowNanoseconds();
+        int built = 0;
+        while (built < count && arenaInsert(arena, keys[built])) {
+            built++;
+        }
+        long long insertTime = nowNanoseconds() - start;
+        if (built < count) {
+            printf("Arena ran out of memory after %d keys\n", built);
+            arenaFree(arena);
+            break;
+        }
+        long long found = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups; i++) {
+            found += arenaSearch(arena, keys[nextRandom(&seed) % count]);
+        }
+        long long searchTime = nowNanoseconds() - start;
+        if (found != lookups) {
+            printf("%lld of %d arena lookups missed\n", lookups - found, lookups);
+        }
+        int arenaTreeHeight = arenaHeight(arena, arena->root);
+        double arenaBytesPerKey = (double)arenaBytes(arena) / count;
+        start = nowNanoseconds();
+        arenaFree(arena);
+        long long freeTime = nowNanoseconds() - start;
+        printf("%10d %-8s %7d %10.2f %12.2f %12.2f %10.2f\n", count, "arena", arenaTreeHeight, arenaBytesPerKey,
+               count * 1000.0 / insertTime, lookups * 1000.0 / searchTime, freeTime / 1e6);
+        
+        if (count <= pointerLimit) {
+            struct tree tree = { NULL, TREE_AVL, 0 };
+            found = 0;
+            start = nowNanoseconds();
+            for (int i = 0; i < count; i++) {
+                insert(&tree, keys[i]);
+            }
+            insertTime = nowNanoseconds() - start;
+            start = nowNanoseconds();
+            for (int i = 0; i < lookups; i++) {
+                found += search(tree.root, keys[nextRandom(&seed) % count]);
+            }
+            searchTime = nowNanoseconds() - start;
+            if (found != lookups) {
+                printf("%lld of %d pointer lookups missed\n", lookups - found, lookups);
+            }
+            int pointerTreeHeight = height(tree.root);
+            start = nowNanoseconds();
+            freeTree(tree.root);
+            freeTime = nowNanoseconds() - start;
+            printf("%10d %-8s %7d %10d %12.2f %12.2f %10.2f\n", count, "pointer", pointerTreeHeight, pointerBytes,
+                   count * 1000.0 / insertTime, lookups * 1000.0 / searchTime, freeTime / 1e6);
+        }
+        if (count == maxCount) {
+            break;
+        }
+    }
+    if (maxCount > pointerLimit) {
+        printf("Pointer nodes stop at %d keys\n", pointerLimit);
+    }
+    free(keys);
+}
+void benchmarkFrozen(int maxCount) {
+    // Pointer search on an AVL tree against search on its frozen copy, half hits and
+    // half misses, at 1M and every tenfold size up to maxCount
+    const int lookups = 4000000;
+    int* keys = (int*)malloc(maxCount * sizeof(int));
+    int* queries = (int*)malloc(lookups * sizeof(int));
+    unsigned long long seed = 19;
+    printf("%10s %7s %10s %14s %14s %14s %8s\n", "keys", "height", "freeze(ms)", "pointer(M/s)", "frozen(M/s)", "rank(M/s)", "speedup");
+    for (int count = maxCount < 1000000 ? maxCount : 1000000; ; count = count < maxCount / 10 ? count * 10 : maxCount) {
+        struct tree tree = { NULL, TREE_AVL, 0 };
+        for (int i = 0; i < count; i++) {
+            keys[i] = (int)(nextRandom(&seed) >> 33) * 2; // Odd numbers stay free for misses
+            insert(&tree, keys[i]);
+        }
+        for (int i = 0; i < lookups; i++) {
+            queries[i] = keys[nextRandom(&seed) % count] + (i & 1);
+        }
+        long long start = nowNanoseconds();
+        struct frozenTree* frozen = freezeTree(&tree);
+        long long freezeTime = nowNanoseconds() - start;
+        long long pointerFound = 0, frozenFound = 0, rankSum = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups; i++) {
+            pointerFound += search(tree.root, queries[i]);
+        }
+        long long pointerTime = nowNanoseconds() - start;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups; i++) {
+            frozenFound += frozenSearch(frozen, queries[i]);
+        }
+        long long frozenTime = nowNanoseconds() - start;
+        start = nowNanoseconds();
+        for (int i = 0; i < lookups; i++) {
+            rankSum += frozenRank(frozen, queries[i]);
+        }
+        long long rankTime = nowNanoseconds() - start;
+        if (pointerFound != frozenFound || pointerFound < lookups / 2 || rankSum < 0) {
+            printf("Frozen search found %lld keys, pointer search %lld\n", frozenFound, pointerFound);
+        }
+        printf("%10d %7d %10.2f %14.2f %14.2f %14.2f %7.2fx\n", count, height(tree.root), freezeTime / 1e6,
+               lookups * 1000.0 / pointerTime, lookups * 1000.0 / frozenTime, lookups * 1000.0 / rankTime,
+               (double)pointerTime / frozenTime);
+        frozenFree(frozen);
+        freeTree(tree.root);
+        if (count == maxCount) {
+            break;
+        }
+    }
+    free(queries);
+    free(keys);
+}
+void benchmarkOrderStatistics(int count) {
+    // Order-statistic queries on an augmented AVL tree against answering them by walking keys
+    const int queries = 1000000;
+    const int walks = 5; // Full inorder walks are slow, so only a few are timed
+    const int rangeWidth = 1 << 22; // Spans about count / 512 random keys; low stays below 2^30, so no overflow
+    unsigned long long seed = 23;
+    struct tree tree = { NULL, TREE_AVL, 1 };
+    for (int i = 0; i < count; i++) {
+        insert(&tree, (int)(nextRandom(&seed) >> 33));
+    }
+    long long checksum = 0, expected = 0, sum;
+    long long start = nowNanoseconds();
+    for (int i = 0; i < queries; i++) {
+        checksum += kthSmallest(&tree, 1 + (int)(nextRandom(&seed) % count));
+    }
+    double kthTime = (double)(nowNanoseconds() - start) / queries;
+    start = nowNanoseconds();
+    for (int i = 0; i < queries; i++) {
+        checksum += rankOf(&tree, (int)(nextRandom(&seed) >> 33));
+    }
+    double rankTime = (double)(nowNanoseconds() - start) / queries;
+    // The same ranges answered three ways, so their counts and sums must agree
+    unsigned long long rangeSeed = seed;
+    start = nowNanoseconds();
+    for (int i = 0; i < queries; i++) {
+        int low = (int)(nextRandom(&seed) >> 34);
+        expected += countInRange(&tree, low, low + rangeWidth, &sum) + sum;
+    }
+    double rangeTime = (double)(nowNanoseconds() - start) / queries;
+    seed = rangeSeed;
+    long long scanned = 0;
+    start = nowNanoseconds();
+    for (int i = 0; i < queries; i++) {
+        int low = (int)(nextRandom(&seed) >> 34), key;
+        struct treeIterator* it = rangeIteratorCreate(tree.root, low, low + rangeWidth);
+        while (iteratorNext(it, &key)) {
+            scanned += 1 + (long long)key;
+        }
+        iteratorFree(it);
+    }
+    double scanTime = (double)(nowNanoseconds() - start) / queries;
+    seed = rangeSeed;
+    long long walked = 0;
+    start = nowNanoseconds();
+    for (int i = 0; i < walks; i++) {
+        int low = (int)(nextRandom(&seed) >> 34), key;
+        struct treeIterator* it = iteratorCreate(tree.root, ORDER_INORDER);
+        while (iteratorNext(it, &key)) {
+            if (key >= low && key <= low + rangeWidth) {
+                walked += 1 + (long long)key;
+            }
+        }
+        iteratorFree(it);
+    }
+    double walkTime = (double)(nowNanoseconds() - start) / walks;
+    seed = rangeSeed;
+    long long walkExpected = 0;
+    for (int i = 0; i < walks; i++) {
+        int low = (int)(nextRandom(&seed) >> 34);
+        walkExpected += countInRange(&tree, low, low + rangeWidth, &sum) + sum;
+    }
+    if (scanned != expected || walked != walkExpected || checksum < 0) {
+        printf("Range answers disagree\n");
+    }
+    printf("%d keys, height %d, ranges of %d values\n", count, height(tree.root), rangeWidth);
+    printf("%-32s %14s\n", "query", "time/query(ns)");
+    printf("%-32s %14.1f\n", "k-th smallest", kthTime);
+    printf("%-32s %14.1f\n", "rank of key", rankTime);
+    printf("%-32s %14.1f\n", "count and sum in range", rangeTime);
+    printf("%-32s %14.1f\n", "range scan iterator", scanTime);
+    printf("%-32s %14.1f\n", "full inorder walk", walkTime);
+    freeTree(tree.root);
 }
 int main(){
-    struct node* root = NULL;
+    struct tree tree = { NULL, TREE_UNBALANCED, 0 };
     int choice, data;
     do{
         printf("\n\nBinary Search Tree Operations\n");
@@ -149,58 +1601,73 @@ int main(){
         printf("10. Width of Tree\n");
         printf("11. Depth of Node\n");
         printf("12. Diameter of Tree\n");
-        printf("13. Exit\n");
+        printf("13. Switch Balancing Mode (now %s)\n", tree.mode == TREE_AVL ? "AVL" : "unbalanced");
+        printf("14. Switch Augmented Metrics (now %s)\n", tree.augmented ? "on" : "off");
+        printf("15. All Metrics in One Pass\n");
+        printf("16. Inorder From Value\n");
+        printf("17. Benchmark Balancing\n");
+        printf("18. Benchmark B+ Tree vs Binary Tree\n");
+        printf("19. Benchmark Metrics\n");
+        printf("20. Benchmark Traversal\n");
+        printf("21. Benchmark Arena Nodes vs Pointer Nodes\n");
+        printf("22. Frozen Search and Rank\n");
+        printf("23. Benchmark Frozen Tree\n");
+        printf("24. K-th Smallest Value\n");
+        printf("25. Rank of Value\n");
+        printf("26. Count, Sum and List in Range\n");
+        printf("27. Benchmark Order Statistics\n");
+        printf("28. Exit\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
         switch (choice) {
             case 1:
                 printf("Enter value to insert: ");
                 scanf("%d", &data);
-                insert(&root, data);
+                insert(&tree, data);
                 break;
             case 2:
                 printf("Inorder Traversal: ");
-                inorder(root);
+                inorder(tree.root);
                 printf("\n");
                 break;
             case 3:
                 printf("Preorder Traversal: ");
-                preorder(root);
+                preorder(tree.root);
                 printf("\n");
                 break;
             case 4:
                 printf("Postorder Traversal: ");
-                postorder(root);
+                postorder(tree.root);
                 printf("\n");
                 break;
             case 5:
-                printf("Height of Tree: %d\n", height(root));
+                printf("Height of Tree: %d\n", height(tree.root));
                 break;
             case 6:
                 printf("Enter value to search: ");
                 scanf("%d", &data);
-                if (search(root, data)) {
+                if (search(tree.root, data)) {
                     printf("Value %d found in the tree.\n", data);
                 } else {
                     printf("Value %d not found in the tree.\n", data);
                 }
                 break;
             case 7:
-                printf("Minimum Value: %d\n", findMin(root));
+                printf("Minimum Value: %d\n", findMin(&tree));
                 break;
             case 8:
-                printf("Maximum Value: %d\n", findMax(root));
+                printf("Maximum Value: %d\n", findMax(&tree));
                 break;
             case 9:
-                printf("Size of Tree: %d\n", size(root));
+                printf("Size of Tree: %d\n", size(&tree));
                 break;
             case 10:
-                printf("Width of Tree: %d\n", width(root));
+                printf("Width of Tree: %d\n", width(tree.root));
                 break;  
             case 11:
                 printf("Enter value to find depth: ");
                 scanf("%d", &data);
-                int depthValue = depth(root, data);
+                int depthValue = depth(tree.root, data);
                 if (depthValue != -1) {
                     printf("Depth of node with value %d: %d\n", data, depthValue);
                 } else {
@@ -208,16 +1675,139 @@ int main(){
                 }
                 break;
             case 12:
-                printf("Diameter of Tree: %d\n", diameter(root));
+                printf("Diameter of Tree: %d\n", diameter(&tree));
                 break;
             case 13:
-                freeTree(root);
+                tree.mode = tree.mode == TREE_AVL ? TREE_UNBALANCED : TREE_AVL;
+                printf("Later inserts are %s\n", tree.mode == TREE_AVL ? "rebalanced (AVL)" : "not rebalanced");
+                break;
+            case 14:
+                setAugmentedMetrics(&tree, !tree.augmented);
+                printf("Size, diameter, minimum and maximum are %s\n",
+                       tree.augmented ? "kept on every node" : "computed on demand");
+                break;
+            case 15: {
+                struct treeMetrics metrics = computeMetrics(tree.root);
+                printf("Size: %d, Height: %d, Diameter: %d, Minimum: %d, Maximum: %d, Sum: %lld\n",
+                       metrics.size, metrics.height, metrics.diameter, metrics.min, metrics.max, metrics.sum);
+                break;
+            }
+            case 16: {
+                printf("Enter value to start from: ");
+                scanf("%d", &data);
+                struct treeIterator* it = iteratorCreate(tree.root, ORDER_INORDER);
+                iteratorSeek(it, data);
+                int keys[TRAVERSAL_BATCH];
+                int count;
+                printf("Inorder From %d: ", data);
+                while ((count = iteratorNextBatch(it, keys, TRAVERSAL_BATCH)) > 0) {
+                    for (int i = 0; i < count; i++) {
+                        printf("%d ", keys[i]);
+                    }
+                }
+                printf("\n");
+                iteratorFree(it);
+                break;
+            }
+            case 17:
+                printf("Enter number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkBalancing(data);
+                }
+                break;
+            case 18:
+                printf("Enter largest number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkBPlusTree(data);
+                }
+                break;
+            case 19:
+                printf("Enter number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkMetrics(data);
+                }
+                break;
+            case 20:
+                printf("Enter number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkTraversal(data);
+                }
+                break;
+            case 21:
+                printf("Enter largest number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkArena(data);
+                }
+                break;
+            case 22: {
+                printf("Enter value to look up: ");
+                scanf("%d", &data);
+                struct frozenTree* frozen = freezeTree(&tree);
+                printf("Value %d %s in the frozen tree, %d smaller keys (minimum %d, maximum %d).\n", data,
+                       frozenSearch(frozen, data) ? "found" : "not found", frozenRank(frozen, data),
+                       frozenMin(frozen), frozenMax(frozen));
+                frozenFree(frozen);
+                break;
+            }
+            case 23:
+                printf("Enter largest number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkFrozen(data);
+                }
+                break;
+            case 24:
+                printf("Enter k: ");
+                scanf("%d", &data);
+                if (data >= 1 && data <= size(&tree)) {
+                    printf("K-th smallest value for k = %d: %d\n", data, kthSmallest(&tree, data));
+                } else {
+                    printf("The tree has no %d-th smallest value.\n", data);
+                }
+                break;
+            case 25:
+                printf("Enter value: ");
+                scanf("%d", &data);
+                printf("%d keys are smaller than %d\n", rankOf(&tree, data), data);
+                break;
+            case 26: {
+                int high;
+                long long sum;
+                printf("Enter low and high: ");
+                scanf("%d %d", &data, &high);
+                int count = countInRange(&tree, data, high, &sum);
+                printf("%d keys in [%d, %d], sum %lld: ", count, data, high, sum);
+                struct treeIterator* it = rangeIteratorCreate(tree.root, data, high);
+                int keys[TRAVERSAL_BATCH];
+                while ((count = iteratorNextBatch(it, keys, TRAVERSAL_BATCH)) > 0) {
+                    for (int i = 0; i < count; i++) {
+                        printf("%d ", keys[i]);
+                    }
+                }
+                printf("\n");
+                iteratorFree(it);
+                break;
+            }
+            case 27:
+                printf("Enter number of keys: ");
+                scanf("%d", &data);
+                if (data > 0) {
+                    benchmarkOrderStatistics(data);
+                }
+                break;
+            case 28:
+                freeTree(tree.root);
                 printf("Exiting...\n");
                 break;
             default:
                 printf("Invalid choice! Please try again.\n");
         }
     }
-    while (choice != 13);
+    while (choice != 28);
     return 0;
 }
\ No newline at end of file
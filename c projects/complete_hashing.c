@@ -1,10 +1,97 @@
+// Build: gcc -O2 complete_hashing.c -o complete_hashing -lm -lpthread
+// Run without arguments for the menu, or with --help for the benchmark harness options
+#ifdef __linux__
+#define _GNU_SOURCE // sched_setaffinity and the CPU_* macros
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <time.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1 // From linux/mempolicy.h, which is not always installed
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+#endif
+
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
 
 #define TABLE_SIZE 10
 #define PRIME 7
+#define UNIVERSAL_PRIME 2147483647ULL // 2^31 - 1
+#define DEFAULT_MAX_LOAD_FACTOR 0.75
+#define DEFAULT_MAX_TOMBSTONE_FACTOR 0.25
+#define REHASH_BATCH 64 // Old slots migrated per operation during an incremental rehash
+#define PLACE_DUPLICATE -2
+#define NODE_SLAB_SIZE 4096 // Nodes carved out of each pool allocation
+#define BUCKET_SLOTS 13 // Keys per bucket: 8 (overflow) + 4 (count) + 13 * 4 = one 64-byte cache line
+#define CACHE_LINE_SIZE 64
+#define LOCK_STRIPES 64 // Writer locks shared by a concurrent table's buckets
+#define MAX_READER_THREADS 64 // Threads past this read under the stripe lock instead
+#define RETIRE_BATCH 64 // Retired nodes collected before trying to free them
+#define PREFETCH_BLOCK 16 // Keys whose slots are prefetched together by the batch methods
+#define BULK_PARTITIONS_PER_THREAD 8 // More partitions than threads evens out uneven partitions
+#define SHARD_ROUTE_SALT 0x9E3779B97F4A7C15ULL // Keeps the shard choice independent of the hash inside each shard
+#define MAX_NUMA_NODES 64 // Nodes that fit in one mbind mask word
+#define KV_EMPTY_HASH 0ULL // Stored hashes below 2 mark slot states, real hashes are moved up past them
+#define KV_DELETED_HASH 1ULL
+#define STATS_HISTOGRAM_BUCKETS 16 // Lengths 0 to 14 counted one by one, the last bucket takes everything longer
+#define CUCKOO_BUCKET_SLOTS 4 // 16-byte buckets, so a lookup reads at most two cache lines plus the stash
+#define CUCKOO_STASH_SIZE 4 // Keys whose eviction walk failed, checked by every lookup
+#define CUCKOO_MAX_KICKS 500 // Evictions tried before a key goes to the stash
+#define CUCKOO_MAX_LOAD_FACTOR 0.9 // Two choices of 4-way buckets only start failing inserts around 0.95
+#define HASH_FILE_MAGIC 0x4F414854u // "OAHT"; reads back differently on a machine with the other byte order
+#define HASH_FILE_VERSION 2 // Version 1 probed power-of-two tables with the modulo sequences
+#define PERFECT_HASH_GAMMA 1.0 // Bits per remaining key at each level; 1.0 is about 3 bits per key in total
+#define PERFECT_HASH_MAX_LEVELS 32 // Keys still colliding after this many levels are kept in a sorted array
+#define RANK_BLOCK_BITS 512 // Bits covered by each precomputed rank
+#define BLOOM_BLOCK_BITS 512 // A Bloom filter key sets all its bits inside one cache line
+#define CUCKOO_FILTER_SLOTS 4 // Fingerprints per cuckoo filter bucket
+#define CUCKOO_FILTER_MAX_LOAD_FACTOR 0.95
+#define SWISS_GROUP_SIZE 16
+#define SWISS_EMPTY 0x80
+#define SWISS_DELETED 0xFE
+
+// Every hash function maps a key to an index in [0, size)
+typedef int (*HashFunction)(int key, int size);
+
+// Hash functions a table can be created with, in the order of hashFunctions[]
+enum HashFunctionId {
+    HASH_DIVISION,
+    HASH_MID_SQUARE,
+    HASH_FOLDING,
+    HASH_MULTIPLICATION,
+    HASH_UNIVERSAL,
+    HASH_MULTIPLY_XORSHIFT,
+    HASH_FIBONACCI,
+    HASH_FUNCTION_COUNT
+};
+
+struct HashFunctionEntry {
+    const char* name;
+    HashFunction function;
+};
 
 // Node structure for chaining
 struct Node {
@@ -12,23 +99,317 @@ struct Node {
     struct Node* next;
 };
 
+// Block of nodes handed out by a NodePool
+struct NodeSlab {
+    struct NodeSlab* next;
+    int capacity;
+    int used; // Nodes handed out from the front of nodes[] so far
+    struct Node nodes[];
+};
+
+// Node allocator for chaining: bump-allocates from slabs, recycles through a free list
+struct NodePool {
+    struct NodeSlab* slabs; // Newest first
+    struct Node* freeList; // Linked through Node.next
+};
+
+// Cache-line sized bucket for chaining without a pointer chase per key
+struct CacheLineBucket {
+    struct CacheLineBucket* overflow; // Only allocated once the bucket spills
+    int count;
+    int keys[BUCKET_SLOTS];
+};
+
+// Counters kept by a table; the occupancy part is only filled in by collect*Stats
+struct TableStats {
+    long long hitProbes[STATS_HISTOGRAM_BUCKETS]; // Searches that found the key, by slots or nodes compared
+    long long missProbes[STATS_HISTOGRAM_BUCKETS];
+    long long longestProbe;
+    long long resizes; // New slot arrays, for growth and tombstone compaction alike
+    long long rehashedKeys; // Keys moved into a new slot array
+    // Occupancy snapshot
+    int chaining;
+    int keys;
+    int slots;
+    int tombstones;
+    long long runLengths[STATS_HISTOGRAM_BUCKETS]; // Chain lengths, or clusters of non-empty slots for open addressing
+    int longestRun;
+};
+
+// Approximate membership filters a table can put in front of its lookups
+enum FilterKind {
+    FILTER_BLOOM, // Blocked Bloom filter, cannot forget a key
+    FILTER_CUCKOO // Cuckoo filter of fingerprints, supports delete
+};
+
+// "Not present" answers are always right, "maybe present" is wrong at about the target rate
+struct MembershipFilter {
+    enum FilterKind kind;
+    int blockCount; // Bloom: BLOOM_BLOCK_BITS blocks; cuckoo: buckets
+    int hashCount; // Bloom bits set per key
+    unsigned long long* words; // Bloom bits, cache-line aligned
+    void* memory; // Unaligned allocation behind words
+    unsigned short* fingerprints; // Cuckoo: CUCKOO_FILTER_SLOTS per bucket, 0 marks an empty slot
+    unsigned short fingerprintMask;
+    int overflowed; // Cuckoo: an insert found no room, so the filter can no longer rule anything out
+    unsigned long long seed; // Picks cuckoo eviction victims
+    long long lookups;
+    long long rejected; // Lookups answered without touching the table
+};
+
 // HashTable structure for chaining
 struct ChainingHashTable {
     int size;
+    enum HashFunctionId hashFunction;
     struct Node** table;
+    struct NodePool* pool; // NULL mallocs every node on its own
+    long long allocations; // malloc calls made for nodes
+    struct CacheLineBucket* buckets; // Non-NULL keeps keys inline in buckets instead of in table[]
+    void* bucketMemory; // Unaligned allocation behind buckets
+    struct MembershipFilter* filter; // Optional, owned by the table; NULL sends every lookup to the table
+    struct TableStats stats;
 };
 
 // HashTable structure for open addressing
 struct OpenAddressingHashTable {
     int size;
+    enum HashFunctionId hashFunction;
     int* table;
     int* deleted; // To mark deleted slots
+    int count; // Live keys, including ones not yet migrated out of oldTable
+    int used; // Occupied slots in table, tombstones included
+    int tombstones;
+    double maxLoadFactor; // 0 keeps the capacity fixed
+    double maxTombstoneFactor;
+    int rehashBatch; // 0 rehashes everything inside a single operation
+    // Incremental rehash state: oldTable is drained into table a batch at a time
+    int oldSize;
+    int* oldTable;
+    int* oldDeleted;
+    int rehashIndex;
+    struct MembershipFilter* filter; // Optional, owned by the table; NULL sends every lookup to the table
+    struct TableStats stats;
+};
+
+// HashTable structure for the Swiss table: one control byte per slot, matched 16 at a time
+struct SwissHashTable {
+    int groupCount; // Always a power of two
+    int count;
+    int tombstones;
+    unsigned char* control; // SWISS_EMPTY, SWISS_DELETED, or the low 7 hash bits of the key
+    int* keys;
+};
+
+// HashTable structure for cuckoo hashing: a key lives in one of its two buckets or in the stash
+struct CuckooHashTable {
+    int bucketCount;
+    int count;
+    int* slots; // bucketCount * CUCKOO_BUCKET_SLOTS keys, -1 marks an empty slot
+    int stash[CUCKOO_STASH_SIZE];
+    int stashCount;
+    unsigned long long seed; // Picks eviction victims
+    long long kicks; // Evictions done by inserts so far
+};
+
+// Minimal perfect hash of a fixed key set (BBHash): each level is a bit array with one
+// set bit for every key that had a position to itself, and the rest retry at the next level
+struct PerfectHashTable {
+    int count;
+    int levelCount;
+    long long levelOffsets[PERFECT_HASH_MAX_LEVELS + 1]; // First bit of each level; the last entry is the total
+    unsigned long long* bits;
+    unsigned int* ranks; // Set bits before each RANK_BLOCK_BITS block
+    int* overflowKeys; // Sorted; they take the indexes after the ones the levels hand out
+    int overflowCount;
+    int* keys; // Key at each index, so keys outside the set can be turned away
+};
+
+// Node structure for the concurrent chaining table
+struct ConcurrentNode {
+    int data;
+    _Atomic(struct ConcurrentNode*) next;
+    struct ConcurrentNode* retiredNext; // Link in the retired list once unlinked
+    unsigned long long retiredEpoch;
+};
+
+// Epoch a reader announced on entry, 0 while outside a search; one cache line each
+struct ReaderEpoch {
+    atomic_ullong epoch;
+    char padding[CACHE_LINE_SIZE - sizeof(atomic_ullong)];
+};
+
+// HashTable structure for chaining shared between threads: writers lock one
+// stripe, readers take no lock and unlinked nodes are freed by epoch
+struct ConcurrentChainingHashTable {
+    int size;
+    enum HashFunctionId hashFunction;
+    _Atomic(struct ConcurrentNode*)* table;
+    pthread_mutex_t stripes[LOCK_STRIPES];
+    atomic_ullong globalEpoch;
+    struct ReaderEpoch readers[MAX_READER_THREADS];
+    pthread_mutex_t retireLock;
+    struct ConcurrentNode* retired;
+    int retiredCount;
+};
+
+// Collision strategies shared by the generic tables
+enum CollisionStrategy {
+    STRATEGY_CHAINING,
+    STRATEGY_LINEAR_PROBING,
+    STRATEGY_QUADRATIC_PROBING,
+    STRATEGY_DOUBLE_HASHING,
+    STRATEGY_COUNT
+};
+
+// Entry of the key/value map: a slot for open addressing, a node for chaining
+struct KeyValueEntry {
+    unsigned long long hash; // Full hash of key, compared before the key bytes
+    char* key; // Owned copy, not NUL-terminated
+    size_t keyLength;
+    long long value;
+    struct KeyValueEntry* next; // Chaining only
+};
+
+// Key/value map with byte-string keys and 64-bit values
+struct KeyValueMap {
+    enum CollisionStrategy strategy;
+    int size;
+    int count;
+    int used; // Open addressing slots holding an entry or a tombstone
+    struct KeyValueEntry* slots; // Open addressing
+    struct KeyValueEntry** chains; // Chaining
+    long long keyComparisons; // memcmp calls, i.e. stored hash and length both matched
+};
+
+// Work handed to each thread of the concurrent benchmark
+struct ConcurrentWorkload {
+    struct ConcurrentChainingHashTable* ht;
+    int keyRange;
+    int operations;
+    int readPercent;
+    unsigned long long seed;
+};
+
+// Steps of a bulk build, each run by every thread before the next starts
+enum BulkBuildPhase {
+    BULK_COUNT, // Count each thread's keys per partition
+    BULK_SCATTER, // Copy the keys into partitioned[], grouped by partition
+    BULK_BUILD // Fill each partition's slots or buckets
+};
+
+// Work handed to each thread of a bulk build. Keys are split into partitions by
+// home slot, so threads fill disjoint ranges of the table without locking;
+// thread t builds partitions t, t + threadCount, ...
+struct BulkBuildWork {
+    enum BulkBuildPhase phase;
+    int thread;
+    int threadCount;
+    int partitionCount;
+    const int* keys;
+    int count;
+    HashFunction hash;
+    int size;
+    int* partitioned;
+    int* partitionStart; // partitionCount + 1 offsets into partitioned
+    int* cursors; // This thread's key count per partition, then its next write position
+    int* overflowCounts; // Keys per partition left at the front of its range for the serial pass
+    int* table; // Open addressing slots, or NULL
+    struct Node** buckets; // Chaining buckets, or NULL
+    struct Node* nodes; // Chaining: nodes[i] holds partitioned[i]
+    int placed; // Keys this thread wrote into table
+};
+
+// Probe sequences shared by the open addressing methods
+enum ProbeSequence {
+    PROBE_LINEAR,
+    PROBE_QUADRATIC,
+    PROBE_DOUBLE,
+    PROBE_ROBIN_HOOD // Linear probing kept ordered by displacement, no tombstones
+};
+
+// Wrapper splitting the key space over independent tables, each of which can keep its
+// memory on its own NUMA node. Like the tables inside, it is not safe to share between threads
+struct ShardedHashTable {
+    int shardCount;
+    enum ProbeSequence probe; // Open addressing shards only
+    struct ChainingHashTable** chainingShards; // NULL when the shards use open addressing
+    struct OpenAddressingHashTable** openShards; // NULL when the shards use chaining
+    int* shardNodes; // NUMA node of each shard's memory, -1 leaves it wherever it was first touched
+    void** boundMemory; // Slot array or node slab last bound for each shard
+    int bindFailures; // mbind calls that failed, e.g. on kernels without NUMA support
+    struct TableStats stats; // Sum over the shards, filled in by collectShardedStats
+};
+
+// Work handed to the lookup thread of the sharded benchmark
+struct ShardedLookupWork {
+    struct ShardedHashTable* ht;
+    const int* queries;
+    int count;
+    int node; // Node the thread runs on
+    int pinned;
+    long long found;
+    long long elapsed;
+};
+
+// Header of a saved open addressing table, followed by size ints: the keys, -1 for empty.
+// The table is written without tombstones, so it can be probed straight from the mapping
+struct HashTableFileHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int hashFunction; // enum HashFunctionId
+    unsigned int probe; // enum ProbeSequence
+    int size;
+    int count;
+    unsigned int reserved[2]; // Keeps the slots 32-byte aligned
+};
+
+// Saved table opened read-only: mapped on POSIX systems, read into memory on Windows
+struct MappedHashTable {
+    const struct HashTableFileHeader* header;
+    const int* slots;
+    HashFunction hash;
+    void* data;
+    size_t length;
+};
+
+// Key sets and access patterns the benchmark harness can drive a table with
+enum Workload {
+    WORKLOAD_UNIFORM, // Scrambled keys, every live key equally likely
+    WORKLOAD_ZIPF, // Scrambled keys, a few hot keys take most operations
+    WORKLOAD_SEQUENTIAL, // Keys 0, 1, 2, ... accessed in order
+    WORKLOAD_ADVERSARIAL, // Keys that all fall on a few residues of the starting table size
+    WORKLOAD_COUNT
+};
+
+// Command line settings of the benchmark harness; -1 in a selector means all of them
+struct BenchmarkOptions {
+    int keys; // Keys loaded before timing starts
+    int operations;
+    double loadFactor; // Starting load, and the growth limit of the open addressing tables
+    int readPercent;
+    int insertPercent; // The rest of the operations are deletes
+    int missPercent; // Reads that look up an absent key
+    double zipfExponent;
+    double timeBudget; // Seconds of timed operations per case before it is cut short
+    unsigned long long seed;
+    int workload;
+    int strategy;
+    int hashFunction;
+    int json;
+    int stats; // Add each table's TableStats to the JSON rows
+    int powerOfTwo; // Power-of-two table sizes, so open addressing wraps with masks
 };
 
 // Function prototypes
 struct ChainingHashTable* createChainingHashTable(int size);
+struct ChainingHashTable* createChainingHashTableWithHash(int size, enum HashFunctionId hashFunction);
+struct ChainingHashTable* createPooledChainingHashTable(int size, enum HashFunctionId hashFunction);
+struct ChainingHashTable* createBucketChainingHashTable(int size, enum HashFunctionId hashFunction);
 void freeChainingHashTable(struct ChainingHashTable* ht);
 struct OpenAddressingHashTable* createOpenAddressingHashTable(int size);
+struct OpenAddressingHashTable* createOpenAddressingHashTableWithHash(int size, enum HashFunctionId hashFunction);
+struct OpenAddressingHashTable* createResizableOpenAddressingHashTable(int size, enum HashFunctionId hashFunction, double maxLoadFactor, double maxTombstoneFactor, int rehashBatch);
+struct OpenAddressingHashTable* createPowerOfTwoOpenAddressingHashTable(int size, enum HashFunctionId hashFunction);
 void freeOpenAddressingHashTable(struct OpenAddressingHashTable* ht);
 
 // Hash Functions
@@ -37,14 +418,110 @@ int midSquareMethod(int key, int size);
 int foldingMethod(int key, int size);
 int multiplicationMethod(int key, int size);
 int universalHashing(int key, int size);
+unsigned long long mixBits(unsigned long long x);
+int reduceToRange(unsigned long long hash, int size);
+int multiplyXorShiftHash(int key, int size);
+int fibonacciHash(int key, int size);
 void printHashTable(struct OpenAddressingHashTable* ht);
 
+// Node pool methods
+struct NodePool* createNodePool(void);
+void freeNodePool(struct NodePool* pool);
+struct Node* allocateNode(struct ChainingHashTable* ht);
+void releaseNode(struct ChainingHashTable* ht, struct Node* node);
+
+// Membership filter methods
+double blockedBloomFalsePositiveRate(double bitsPerKey, int hashCount);
+struct MembershipFilter* createBloomFilter(int expectedKeys, double falsePositiveRate);
+struct MembershipFilter* createCuckooFilter(int expectedKeys, double falsePositiveRate);
+void freeMembershipFilter(struct MembershipFilter* filter);
+unsigned int bloomBitPosition(unsigned long long* hash, int i);
+int alternateFilterBucket(struct MembershipFilter* filter, int bucket, unsigned short fingerprint);
+void cuckooFilterBuckets(struct MembershipFilter* filter, int key, unsigned short* fingerprint, int* first, int* second);
+int addToFilter(struct MembershipFilter* filter, int key);
+int mayContain(struct MembershipFilter* filter, int key);
+int removeFromFilter(struct MembershipFilter* filter, int key);
+void attachChainingFilter(struct ChainingHashTable* ht, struct MembershipFilter* filter);
+void attachOpenAddressingFilter(struct OpenAddressingHashTable* ht, struct MembershipFilter* filter);
+
+// Statistics methods
+int histogramBucket(long long length);
+void recordProbe(struct TableStats* stats, int found, long long probes);
+void resetTableStats(struct TableStats* stats);
+struct TableStats* collectChainingStats(struct ChainingHashTable* ht);
+struct TableStats* collectOpenAddressingStats(struct OpenAddressingHashTable* ht);
+void printTableStatsJson(const struct TableStats* stats);
+
+// Cache-line bucket chaining methods
+int insertBucketChaining(struct ChainingHashTable* ht, int index, int key);
+int searchBucketChaining(struct ChainingHashTable* ht, int index, int key);
+int deleteBucketChaining(struct ChainingHashTable* ht, int index, int key);
+void printBucketChaining(struct ChainingHashTable* ht, int index);
+
 // Chaining methods
 int insertChaining(struct ChainingHashTable* ht, int key);
 int searchChaining(struct ChainingHashTable* ht, int key);
 int deleteChaining(struct ChainingHashTable* ht, int key);
 void printChainingHashTable(struct ChainingHashTable* ht);
 
+// Open addressing core shared by all probe sequences
+long long probeOffset(enum ProbeSequence probe, int key, int i, int size);
+int probeStride(enum ProbeSequence probe, int key, int size);
+int displacement(int* table, int size, int index, HashFunction hash);
+int findSlot(int* table, int* deleted, int size, int key, enum ProbeSequence probe, HashFunction hash);
+int placeKey(int* table, int* deleted, int size, int key, enum ProbeSequence probe, HashFunction hash);
+int writeKey(int* table, int* deleted, int size, int slot, int key, enum ProbeSequence probe);
+void backwardShiftDelete(int* table, int size, int index, HashFunction hash);
+int insertOpenAddressing(struct OpenAddressingHashTable* ht, int key, enum ProbeSequence probe);
+int searchOpenAddressing(struct OpenAddressingHashTable* ht, int key, enum ProbeSequence probe);
+int deleteOpenAddressing(struct OpenAddressingHashTable* ht, int key, enum ProbeSequence probe);
+void printOpenAddressingHashTable(struct OpenAddressingHashTable* ht);
+
+// Resizing methods
+int nextPrime(int n);
+int nextPowerOfTwo(int n);
+int nextTableSize(int size);
+int* allocateEmptySlots(int size);
+int needsRehash(struct OpenAddressingHashTable* ht);
+int growCurrentTable(struct OpenAddressingHashTable* ht, enum ProbeSequence probe);
+void moveOldSlot(struct OpenAddressingHashTable* ht, int oldIndex, enum ProbeSequence probe);
+void rehashStep(struct OpenAddressingHashTable* ht, enum ProbeSequence probe);
+void finishRehash(struct OpenAddressingHashTable* ht, enum ProbeSequence probe);
+int startRehash(struct OpenAddressingHashTable* ht, enum ProbeSequence probe);
+
+// Batch methods: results[i] gets what the single-key call would return for keys[i]
+void prefetchOpenAddressingSlots(struct OpenAddressingHashTable* ht, const int* keys, int count);
+void insertBatchOpenAddressing(struct OpenAddressingHashTable* ht, const int* keys, int count, int* results, enum ProbeSequence probe);
+void searchBatchOpenAddressing(struct OpenAddressingHashTable* ht, const int* keys, int count, int* results, enum ProbeSequence probe);
+void deleteBatchOpenAddressing(struct OpenAddressingHashTable* ht, const int* keys, int count, int* results, enum ProbeSequence probe);
+void prefetchChainingBuckets(struct ChainingHashTable* ht, const int* keys, int count);
+void insertBatchChaining(struct ChainingHashTable* ht, const int* keys, int count, int* results);
+void searchBatchChaining(struct ChainingHashTable* ht, const int* keys, int count, int* results);
+void deleteBatchChaining(struct ChainingHashTable* ht, const int* keys, int count, int* results);
+
+// Sharded table methods
+int numaNodeCount(void);
+int bindToNumaNode(void* address, size_t length, int node);
+int pinThreadToNumaNode(int node);
+struct ShardedHashTable* createShardedHashTable(int shardCount, int shardSize, enum CollisionStrategy strategy, enum HashFunctionId hashFunction, const int* shardNodes);
+void freeShardedHashTable(struct ShardedHashTable* ht);
+void bindShardMemory(struct ShardedHashTable* ht, int shard);
+int shardForKey(struct ShardedHashTable* ht, int key);
+int insertSharded(struct ShardedHashTable* ht, int key);
+int searchSharded(struct ShardedHashTable* ht, int key);
+int deleteSharded(struct ShardedHashTable* ht, int key);
+struct TableStats* collectShardedStats(struct ShardedHashTable* ht);
+
+// Bulk build methods: build a new table from a key array on several threads
+int bulkPartition(int home, int size, int partitionCount);
+int partitionFirstSlot(int partition, int size, int partitionCount);
+void* runBulkBuildWork(void* arg);
+void runBulkBuildPhase(struct BulkBuildWork* work, int threadCount, enum BulkBuildPhase phase);
+struct BulkBuildWork* partitionBulkKeys(const int* keys, int count, HashFunction hash, int size, int threadCount);
+void freeBulkBuildWork(struct BulkBuildWork* work);
+struct OpenAddressingHashTable* bulkBuildOpenAddressing(const int* keys, int count, enum HashFunctionId hashFunction, enum ProbeSequence probe, int threadCount);
+struct ChainingHashTable* bulkBuildChaining(const int* keys, int count, enum HashFunctionId hashFunction, int threadCount);
+
 // Linear Probing methods
 int insertLinearProbing(struct OpenAddressingHashTable* ht, int key);
 int searchLinearProbing(struct OpenAddressingHashTable* ht, int key);
@@ -64,6 +541,110 @@ int searchDoubleHashing(struct OpenAddressingHashTable* ht, int key);
 int deleteDoubleHashing(struct OpenAddressingHashTable* ht, int key);
 void printDoubleHashingHashTable(struct OpenAddressingHashTable* ht);
 
+// Robin Hood Hashing methods
+int insertRobinHood(struct OpenAddressingHashTable* ht, int key);
+int searchRobinHood(struct OpenAddressingHashTable* ht, int key);
+int deleteRobinHood(struct OpenAddressingHashTable* ht, int key);
+void printRobinHoodHashTable(struct OpenAddressingHashTable* ht);
+
+// Swiss Table methods
+struct SwissHashTable* createSwissHashTable(int size);
+void freeSwissHashTable(struct SwissHashTable* ht);
+unsigned long long swissHash(int key);
+unsigned int matchGroup(const unsigned char* control, unsigned char tag);
+int countTrailingZeros(unsigned int mask);
+int resizeSwissTable(struct SwissHashTable* ht, int groupCount);
+int insertSwissTable(struct SwissHashTable* ht, int key);
+int searchSwissTable(struct SwissHashTable* ht, int key);
+int deleteSwissTable(struct SwissHashTable* ht, int key);
+void printSwissTable(struct SwissHashTable* ht);
+
+// Persistent file methods
+int saveOpenAddressingHashTable(struct OpenAddressingHashTable* ht, enum ProbeSequence probe, const char* path);
+struct MappedHashTable* openMappedHashTable(const char* path);
+int searchMappedHashTable(const struct MappedHashTable* mapped, int key);
+void closeMappedHashTable(struct MappedHashTable* mapped);
+
+// Perfect Hash methods
+int popCount64(unsigned long long word);
+long long perfectHashPosition(int key, int level, long long levelSize);
+struct PerfectHashTable* createPerfectHash(const int* keys, int count, double gamma);
+void freePerfectHash(struct PerfectHashTable* ph);
+int perfectHashIndex(const struct PerfectHashTable* ph, int key);
+int searchPerfectHash(struct PerfectHashTable* ph, int key);
+void printPerfectHash(struct PerfectHashTable* ph);
+
+// Cuckoo Hashing methods
+struct CuckooHashTable* createCuckooHashTable(int size);
+void freeCuckooHashTable(struct CuckooHashTable* ht);
+void cuckooBuckets(struct CuckooHashTable* ht, int key, int* first, int* second);
+int placeCuckooKey(struct CuckooHashTable* ht, int key, int* homeless);
+int resizeCuckooTable(struct CuckooHashTable* ht, int bucketCount, int extraKey);
+int insertCuckooTable(struct CuckooHashTable* ht, int key);
+int searchCuckooTable(struct CuckooHashTable* ht, int key);
+int deleteCuckooTable(struct CuckooHashTable* ht, int key);
+void printCuckooTable(struct CuckooHashTable* ht);
+
+// Concurrent Chaining methods
+struct ConcurrentChainingHashTable* createConcurrentChainingHashTable(int size, enum HashFunctionId hashFunction);
+void freeConcurrentChainingHashTable(struct ConcurrentChainingHashTable* ht);
+void releaseReaderSlot(void* value);
+void createReaderSlotKey(void);
+int readerSlot(void);
+void reclaimRetiredNodes(struct ConcurrentChainingHashTable* ht);
+int insertConcurrentChaining(struct ConcurrentChainingHashTable* ht, int key);
+int searchConcurrentChaining(struct ConcurrentChainingHashTable* ht, int key);
+int deleteConcurrentChaining(struct ConcurrentChainingHashTable* ht, int key);
+
+// Key/Value Map methods
+struct KeyValueMap* createKeyValueMap(int size, enum CollisionStrategy strategy);
+void freeKeyValueMap(struct KeyValueMap* map);
+unsigned long long hashBytes(const void* key, size_t keyLength);
+int keyValueSlot(struct KeyValueMap* map, unsigned long long hash, int i);
+int keyMatches(struct KeyValueMap* map, struct KeyValueEntry* entry, unsigned long long hash, const void* key, size_t keyLength);
+int findKeyValueSlot(struct KeyValueMap* map, unsigned long long hash, const void* key, size_t keyLength, int* freeSlot);
+int resizeKeyValueMap(struct KeyValueMap* map, int newSize);
+int putKeyValue(struct KeyValueMap* map, const void* key, size_t keyLength, long long value);
+int getKeyValue(struct KeyValueMap* map, const void* key, size_t keyLength, long long* value);
+int deleteKeyValue(struct KeyValueMap* map, const void* key, size_t keyLength);
+void printKeyValueMap(struct KeyValueMap* map);
+
+// Benchmark methods
+long long nowNanoseconds(void);
+unsigned long long nextRandom(unsigned long long* state);
+int compareLongLong(const void* a, const void* b);
+int compareInts(const void* a, const void* b);
+long long percentile(long long* sorted, int n, double p);
+void benchmarkResizing(int keyCount);
+void benchmarkChurn(int keyCount);
+void benchmarkMissLookups(int keyCount);
+void benchmarkHashFunctions(int keyCount);
+void benchmarkNodePool(int keyCount);
+void benchmarkBucketLayout(int keyCount);
+void* runConcurrentWorkload(void* arg);
+void* runShortLivedReader(void* arg);
+void benchmarkConcurrentChaining(int keyCount, int maxThreads);
+void benchmarkBulkBuild(int keyCount, int maxThreads);
+void* runShardedLookups(void* arg);
+void benchmarkShardedTable(int keyCount);
+void benchmarkBatchLookups(int keyCount);
+void benchmarkStringKeys(int keyCount);
+void benchmarkWorstCaseLookups(int keyCount);
+void benchmarkMappedStartup(int keyCount);
+void benchmarkPerfectHash(int keyCount);
+void benchmarkFilters(int keyCount);
+void benchmarkMaskIndexing(int keyCount);
+
+// Benchmark harness methods
+unsigned int permuteKey(unsigned int i);
+long long chainingMemoryUsage(struct ChainingHashTable* ht);
+long long openAddressingMemoryUsage(struct OpenAddressingHashTable* ht);
+int pickPosition(const struct BenchmarkOptions* options, int workload, int liveCount, const double* zipfCdf, int poolSize, unsigned long long* seed, int* cursor);
+void runBenchmarkCase(const struct BenchmarkOptions* options, int workload, int strategy, int hashFunction, int* rowsPrinted);
+void printBenchmarkUsage(const char* program);
+int parseBenchmarkOptions(int argc, char** argv, struct BenchmarkOptions* options);
+int runBenchmarkHarness(int argc, char** argv);
+
 // Hash Functions Implementation
 int divisionMethod(int key, int size) {
     return key % size;
@@ -89,8 +670,12 @@ int midSquareMethod(int key, int size) {
         temp /= 10;
     }
     
-    int result = temp % (int)pow(10, mid_digits);
-    return result % size;
+    long long power = 1;
+    for (int i = 0; i < mid_digits; i++) {
+        power *= 10;
+    }
+    
+    return (int)((temp % power) % size);
 }
 
 int foldingMethod(int key, int size) {
@@ -114,22 +699,133 @@ int multiplicationMethod(int key, int size) {
 }
 
 int universalHashing(int key, int size) {
-    // Simple universal hashing using randomization
-    static int a = 0, b = 0;
+    // Simple universal hashing using randomization: ((a * key + b) mod p) mod size
+    // with p prime and larger than any key, so distinct keys rarely collide before the final mod
+    static unsigned long long a = 0, b = 0;
     if (a == 0) {
         srand(time(NULL));
-        a = rand() % size + 1;
-        b = rand() % size;
+        a = ((unsigned long long)rand() * RAND_MAX + rand()) % (UNIVERSAL_PRIME - 1) + 1;
+        b = ((unsigned long long)rand() * RAND_MAX + rand()) % UNIVERSAL_PRIME;
+    }
+    return (int)(((a * (unsigned int)key + b) % UNIVERSAL_PRIME) % size);
+}
+
+unsigned long long mixBits(unsigned long long x) {
+    // Murmur3 finalizer: every input bit affects every output bit
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+int reduceToRange(unsigned long long hash, int size) {
+    // Scale the top 32 bits into [0, size) with a multiply instead of a modulo
+    return (int)(((hash >> 32) * (unsigned int)size) >> 32);
+}
+
+int multiplyXorShiftHash(int key, int size) {
+    unsigned long long hash = mixBits((unsigned int)key);
+    if ((size & (size - 1)) == 0) {
+        return (int)(hash & (size - 1));
+    }
+    return reduceToRange(hash, size);
+}
+
+int fibonacciHash(int key, int size) {
+    // Knuth's multiplicative hashing with 2^64 / golden ratio: the high bits are the well mixed ones
+    unsigned long long hash = (unsigned int)key * 11400714819323198485ULL;
+    if ((size & (size - 1)) == 0) {
+        int shift = 64 - countTrailingZeros((unsigned int)size);
+        return shift == 64 ? 0 : (int)(hash >> shift);
+    }
+    return reduceToRange(hash, size);
+}
+
+struct HashFunctionEntry hashFunctions[HASH_FUNCTION_COUNT] = {
+    { "Division", divisionMethod },
+    { "Mid-Square", midSquareMethod },
+    { "Folding", foldingMethod },
+    { "Multiplication", multiplicationMethod },
+    { "Universal", universalHashing },
+    { "Multiply-Xorshift", multiplyXorShiftHash },
+    { "Fibonacci", fibonacciHash }
+};
+
+
+// Node Pool Implementation
+struct NodePool* createNodePool(void) {
+    struct NodePool* pool = (struct NodePool*)malloc(sizeof(struct NodePool));
+    pool->slabs = NULL;
+    pool->freeList = NULL;
+    return pool;
+}
+
+void freeNodePool(struct NodePool* pool) {
+    if (pool) {
+        while (pool->slabs) {
+            struct NodeSlab* next = pool->slabs->next;
+            free(pool->slabs);
+            pool->slabs = next;
+        }
+        free(pool);
+    }
+}
+
+struct Node* allocateNode(struct ChainingHashTable* ht) {
+    struct NodePool* pool = ht->pool;
+    if (pool == NULL) {
+        ht->allocations++;
+        return (struct Node*)malloc(sizeof(struct Node));
+    }
+    
+    // Recently freed nodes first: they are the most likely to still be cached
+    if (pool->freeList) {
+        struct Node* node = pool->freeList;
+        pool->freeList = node->next;
+        return node;
+    }
+    if (pool->slabs == NULL || pool->slabs->used == pool->slabs->capacity) {
+        struct NodeSlab* slab = (struct NodeSlab*)malloc(sizeof(struct NodeSlab) + NODE_SLAB_SIZE * sizeof(struct Node));
+        slab->next = pool->slabs;
+        slab->capacity = NODE_SLAB_SIZE;
+        slab->used = 0;
+        pool->slabs = slab;
+        ht->allocations++;
+    }
+    return &pool->slabs->nodes[pool->slabs->used++];
+}
+
+void releaseNode(struct ChainingHashTable* ht, struct Node* node) {
+    if (ht->pool == NULL) {
+        free(node);
+        return;
     }
-    return ((a * key + b) % PRIME) % size;
+    node->next = ht->pool->freeList;
+    ht->pool->freeList = node;
 }
 
+// Slots and chain nodes compared against a key, summed over every table; searches
+// take the difference across their probe loop for their own table's histogram
+long long probeCount = 0;
 
 // Chaining Implementation
 struct ChainingHashTable* createChainingHashTable(int size) {
+    return createChainingHashTableWithHash(size, HASH_DIVISION);
+}
+
+struct ChainingHashTable* createChainingHashTableWithHash(int size, enum HashFunctionId hashFunction) {
     struct ChainingHashTable* ht = (struct ChainingHashTable*)malloc(sizeof(struct ChainingHashTable));
     ht->size = size;
+    ht->hashFunction = hashFunction;
     ht->table = (struct Node**)malloc(size * sizeof(struct Node*));
+    ht->pool = NULL;
+    ht->allocations = 0;
+    ht->buckets = NULL;
+    ht->bucketMemory = NULL;
+    ht->filter = NULL;
+    memset(&ht->stats, 0, sizeof(ht->stats));
     
     for (int i = 0; i < size; i++) {
         ht->table[i] = NULL;
@@ -138,8 +834,42 @@ struct ChainingHashTable* createChainingHashTable(int size) {
     return ht;
 }
 
+struct ChainingHashTable* createPooledChainingHashTable(int size, enum HashFunctionId hashFunction) {
+    struct ChainingHashTable* ht = createChainingHashTableWithHash(size, hashFunction);
+    ht->pool = createNodePool();
+    return ht;
+}
+
+struct ChainingHashTable* createBucketChainingHashTable(int size, enum HashFunctionId hashFunction) {
+    struct ChainingHashTable* ht = createChainingHashTableWithHash(size, hashFunction);
+    // Round the start up to a cache line so each bucket is exactly one line
+    ht->bucketMemory = calloc(1, size * sizeof(struct CacheLineBucket) + CACHE_LINE_SIZE);
+    ht->buckets = (struct CacheLineBucket*)(((size_t)ht->bucketMemory + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1));
+    ht->allocations++;
+    return ht;
+}
+
 void freeChainingHashTable(struct ChainingHashTable* ht) {
     if (ht) {
+        freeMembershipFilter(ht->filter);
+    }
+    if (ht && ht->buckets) {
+        for (int i = 0; i < ht->size; i++) {
+            struct CacheLineBucket* page = ht->buckets[i].overflow;
+            while (page) {
+                struct CacheLineBucket* next = page->overflow;
+                free(page);
+                page = next;
+            }
+        }
+        free(ht->bucketMemory);
+        free(ht->table);
+        free(ht);
+    } else if (ht && ht->pool) {
+        freeNodePool(ht->pool); // Releases every node at once, no chain walk needed
+        free(ht->table);
+        free(ht);
+    } else if (ht) {
         for (int i = 0; i < ht->size; i++) {
             struct Node* current = ht->table[i];
             while (current) {
@@ -154,9 +884,15 @@ void freeChainingHashTable(struct ChainingHashTable* ht) {
 }
 
 int insertChaining(struct ChainingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
+    int index = hashFunctions[ht->hashFunction].function(key, ht->size);
+    if (ht->filter) {
+        addToFilter(ht->filter, key);
+    }
+    if (ht->buckets) {
+        return insertBucketChaining(ht, index, key);
+    }
     
-    struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
+    struct Node* newNode = allocateNode(ht);
     newNode->data = key;
     newNode->next = ht->table[index];
     ht->table[index] = newNode;
@@ -165,32 +901,55 @@ int insertChaining(struct ChainingHashTable* ht, int key) {
 }
 
 int searchChaining(struct ChainingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
+    if (ht->filter && !mayContain(ht->filter, key)) {
+        return -1; // Key not found
+    }
+    int index = hashFunctions[ht->hashFunction].function(key, ht->size);
+    long long before = probeCount;
+    if (ht->buckets) {
+        int found = searchBucketChaining(ht, index, key);
+        recordProbe(&ht->stats, found != -1, probeCount - before);
+        return found;
+    }
     struct Node* current = ht->table[index];
     
     while (current) {
+        probeCount++;
         if (current->data == key) {
+            recordProbe(&ht->stats, 1, probeCount - before);
             return index; // Key found
         }
         current = current->next;
     }
     
+    recordProbe(&ht->stats, 0, probeCount - before);
     return -1; // Key not found
 }
 
 int deleteChaining(struct ChainingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
+    int index = hashFunctions[ht->hashFunction].function(key, ht->size);
+    if (ht->buckets) {
+        int deleted = deleteBucketChaining(ht, index, key);
+        if (deleted && ht->filter) {
+            removeFromFilter(ht->filter, key);
+        }
+        return deleted;
+    }
     struct Node* current = ht->table[index];
     struct Node* prev = NULL;
     
     while (current) {
+        probeCount++;
         if (current->data == key) {
             if (prev) {
                 prev->next = current->next;
             } else {
                 ht->table[index] = current->next;
             }
-            free(current);
+            releaseNode(ht, current);
+            if (ht->filter) {
+                removeFromFilter(ht->filter, key);
+            }
             return 1; // Deletion successful
         }
         prev = current;
@@ -203,6 +962,10 @@ int deleteChaining(struct ChainingHashTable* ht, int key) {
 void printChainingHashTable(struct ChainingHashTable* ht) {
     for (int i = 0; i < ht->size; i++) {
         printf("Index %d: ", i);
+        if (ht->buckets) {
+            printBucketChaining(ht, i);
+            continue;
+        }
         struct Node* current = ht->table[i];
         if (current == NULL) {
             printf("Empty");
@@ -217,314 +980,4194 @@ void printChainingHashTable(struct ChainingHashTable* ht) {
     }
 }
 
-// Open Addressing Implementation
-struct OpenAddressingHashTable* createOpenAddressingHashTable(int size) {
-    struct OpenAddressingHashTable* ht = (struct OpenAddressingHashTable*)malloc(sizeof(struct OpenAddressingHashTable));
-    ht->size = size;
-    ht->table = (int*)malloc(size * sizeof(int));
-    ht->deleted = (int*)malloc(size * sizeof(int));
+// Membership Filter Implementation
+double blockedBloomFalsePositiveRate(double bitsPerKey, int hashCount) {
+    // Keys per block are Poisson distributed, and a block holding i keys answers
+    // "maybe" for a stranger with probability (1 - e^(-k i / B))^k
+    double mean = BLOOM_BLOCK_BITS / bitsPerKey;
+    double weight = exp(-mean), rate = 0;
+    for (int i = 0; i < mean * 4 + 64; i++) {
+        rate += weight * pow(1 - exp(-(double)hashCount * i / BLOOM_BLOCK_BITS), hashCount);
+        weight *= mean / (i + 1);
+    }
+    return rate;
+}
+
+struct MembershipFilter* createBloomFilter(int expectedKeys, double falsePositiveRate) {
+    struct MembershipFilter* filter = (struct MembershipFilter*)calloc(1, sizeof(struct MembershipFilter));
+    filter->kind = FILTER_BLOOM;
     
-    for (int i = 0; i < size; i++) {
-        ht->table[i] = -1; // -1 indicates empty slot
-        ht->deleted[i] = 0; // 0 indicates not deleted
+    // Start from the optimum of a plain Bloom filter and add bits until the blocked
+    // layout, where busy blocks fill up faster than the average, meets the target
+    double bitsPerKey = -log(falsePositiveRate) / (log(2) * log(2));
+    for (;;) {
+        int hashCount = (int)(bitsPerKey * log(2) + 0.5);
+        filter->hashCount = hashCount < 1 ? 1 : hashCount > 16 ? 16 : hashCount;
+        if (bitsPerKey > 64 || blockedBloomFalsePositiveRate(bitsPerKey, filter->hashCount) <= falsePositiveRate) {
+            break;
+        }
+        bitsPerKey += 0.25;
     }
+    long long bits = (long long)(bitsPerKey * (expectedKeys > 0 ? expectedKeys : 1)) + 1;
+    filter->blockCount = (int)((bits + BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS);
     
-    return ht;
+    filter->memory = calloc(1, (size_t)filter->blockCount * (BLOOM_BLOCK_BITS / 8) + CACHE_LINE_SIZE);
+    filter->words = (unsigned long long*)(((size_t)filter->memory + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1));
+    return filter;
 }
 
-void freeOpenAddressingHashTable(struct OpenAddressingHashTable* ht) {
-    if (ht) {
-        free(ht->table);
-        free(ht->deleted);
-        free(ht);
+struct MembershipFilter* createCuckooFilter(int expectedKeys, double falsePositiveRate) {
+    struct MembershipFilter* filter = (struct MembershipFilter*)calloc(1, sizeof(struct MembershipFilter));
+    filter->kind = FILTER_CUCKOO;
+    
+    // A lookup compares against two buckets of fingerprints, so f bits give a
+    // false positive rate of about 2 * CUCKOO_FILTER_SLOTS / 2^f
+    int fingerprintBits = (int)ceil(log2(2.0 * CUCKOO_FILTER_SLOTS / falsePositiveRate));
+    if (fingerprintBits < 4) fingerprintBits = 4;
+    if (fingerprintBits > 16) fingerprintBits = 16;
+    filter->fingerprintMask = (unsigned short)((1u << fingerprintBits) - 1);
+    
+    // At least two buckets, or a key's two candidate buckets would be the same one
+    int blockCount = (int)(expectedKeys / (CUCKOO_FILTER_SLOTS * CUCKOO_FILTER_MAX_LOAD_FACTOR)) + 1;
+    if (blockCount < 2) blockCount = 2;
+    filter->blockCount = blockCount;
+    filter->fingerprints = (unsigned short*)calloc((size_t)blockCount * CUCKOO_FILTER_SLOTS, sizeof(unsigned short));
+    filter->seed = 0x2545F4914F6CDD1DULL;
+    return filter;
+}
+
+void freeMembershipFilter(struct MembershipFilter* filter) {
+    if (filter) {
+        free(filter->memory);
+        free(filter->fingerprints);
+        free(filter);
     }
 }
 
-// Linear Probing Implementation
-int insertLinearProbing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    
-    while (ht->table[index] != -1 && !ht->deleted[index]) {
-        if (ht->table[index] == key) {
-            return 0; // Key already exists
+unsigned int bloomBitPosition(unsigned long long* hash, int i) {
+    // Nine fresh hash bits per position; double hashing inside a 512-bit block repeats
+    // patterns between keys and lands well above the target rate
+    if (i % 7 == 0) {
+        *hash = mixBits(*hash + 0x9E3779B97F4A7C15ULL);
+    }
+    return (unsigned int)(*hash >> (9 * (i % 7))) % BLOOM_BLOCK_BITS;
+}
+
+int alternateFilterBucket(struct MembershipFilter* filter, int bucket, unsigned short fingerprint) {
+    // Partial-key cuckoo hashing: the other bucket comes from the fingerprint alone, so a
+    // fingerprint can be moved without its key. (h - bucket) mod n maps each of the two
+    // buckets to the other for any n, where the usual xor needs a power of two
+    int h = (int)((fingerprint * 0x5BD1E995u) % (unsigned int)filter->blockCount);
+    return h >= bucket ? h - bucket : h - bucket + filter->blockCount;
+}
+
+void cuckooFilterBuckets(struct MembershipFilter* filter, int key, unsigned short* fingerprint, int* first, int* second) {
+    unsigned long long hash = mixBits((unsigned int)key);
+    *fingerprint = (unsigned short)(hash & filter->fingerprintMask);
+    if (*fingerprint == 0) *fingerprint = 1;
+    *first = reduceToRange(hash, filter->blockCount);
+    *second = alternateFilterBucket(filter, *first, *fingerprint);
+}
+
+int addToFilter(struct MembershipFilter* filter, int key) {
+    if (filter->kind == FILTER_BLOOM) {
+        // Every bit of the key lives in one block, picked by the high half of the hash
+        unsigned long long hash = mixBits((unsigned int)key);
+        unsigned long long* block = filter->words + (size_t)reduceToRange(hash, filter->blockCount) * (BLOOM_BLOCK_BITS / 64);
+        for (int i = 0; i < filter->hashCount; i++) {
+            unsigned int bit = bloomBitPosition(&hash, i);
+            block[bit / 64] |= 1ULL << (bit % 64);
         }
-        index = (index + 1) % ht->size;
-        if (index == originalIndex) {
-            return 0; // Table is full
+        return 1;
+    }
+    
+    unsigned short fingerprint;
+    int first, second;
+    cuckooFilterBuckets(filter, key, &fingerprint, &first, &second);
+    int bucket = first;
+    for (int kick = 0; kick <= CUCKOO_MAX_KICKS; kick++) {
+        int candidates[2] = { bucket, alternateFilterBucket(filter, bucket, fingerprint) };
+        for (int c = 0; c < 2; c++) {
+            unsigned short* slots = filter->fingerprints + (size_t)candidates[c] * CUCKOO_FILTER_SLOTS;
+            for (int i = 0; i < CUCKOO_FILTER_SLOTS; i++) {
+                if (slots[i] == 0) {
+                    slots[i] = fingerprint;
+                    return 1;
+                }
+            }
         }
+        
+        // Both full: swap with a random resident, which moves on to its own other bucket
+        unsigned short* slot = filter->fingerprints + (size_t)bucket * CUCKOO_FILTER_SLOTS + nextRandom(&filter->seed) % CUCKOO_FILTER_SLOTS;
+        unsigned short victim = *slot;
+        *slot = fingerprint;
+        fingerprint = victim;
+        bucket = alternateFilterBucket(filter, bucket, fingerprint);
     }
     
-    ht->table[index] = key;
-    ht->deleted[index] = 0;
-    return 1; // Insertion successful
+    filter->overflowed = 1; // One fingerprint is lost; answer "maybe" from now on rather than be wrong
+    return 0;
 }
 
-int searchLinearProbing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    
-    while (ht->table[index] != -1 || ht->deleted[index]) {
-        if (ht->table[index] == key && !ht->deleted[index]) {
-            return index; // Key found
+int mayContain(struct MembershipFilter* filter, int key) {
+    filter->lookups++;
+    int found = 1;
+    if (filter->kind == FILTER_BLOOM) {
+        unsigned long long hash = mixBits((unsigned int)key);
+        unsigned long long* block = filter->words + (size_t)reduceToRange(hash, filter->blockCount) * (BLOOM_BLOCK_BITS / 64);
+        // Build the key's pattern first and compare whole words, with no branch per bit
+        unsigned long long pattern[BLOOM_BLOCK_BITS / 64] = { 0 };
+        for (int i = 0; i < filter->hashCount; i++) {
+            unsigned int bit = bloomBitPosition(&hash, i);
+            pattern[bit / 64] |= 1ULL << (bit % 64);
         }
-        index = (index + 1) % ht->size;
-        if (index == originalIndex) {
-            break; // Table is full, key not found
+        unsigned long long missing = 0;
+        for (int w = 0; w < BLOOM_BLOCK_BITS / 64; w++) {
+            missing |= pattern[w] & ~block[w];
+        }
+        found = missing == 0;
+    } else if (!filter->overflowed) {
+        unsigned short fingerprint;
+        int first, second;
+        cuckooFilterBuckets(filter, key, &fingerprint, &first, &second);
+        unsigned short* a = filter->fingerprints + (size_t)first * CUCKOO_FILTER_SLOTS;
+        unsigned short* b = filter->fingerprints + (size_t)second * CUCKOO_FILTER_SLOTS;
+        found = 0;
+        for (int i = 0; i < CUCKOO_FILTER_SLOTS; i++) {
+            found |= (a[i] == fingerprint) | (b[i] == fingerprint);
         }
     }
-    
-    return -1; // Key not found
+    if (!found) {
+        filter->rejected++;
+    }
+    return found;
 }
 
-int deleteLinearProbing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    
-    while (ht->table[index] != -1 || ht->deleted[index]) {
-        if (ht->table[index] == key && !ht->deleted[index]) {
-            ht->deleted[index] = 1; // Mark as deleted
-            return 1; // Deletion successful
+int removeFromFilter(struct MembershipFilter* filter, int key) {
+    // Only for keys that were added; removing a stranger's matching fingerprint would hide that key
+    if (filter->kind == FILTER_BLOOM) {
+        return 0; // Its bits may be shared with other keys, so they stay set
+    }
+    unsigned short fingerprint;
+    int first, second;
+    cuckooFilterBuckets(filter, key, &fingerprint, &first, &second);
+    int candidates[2] = { first, second };
+    for (int c = 0; c < 2; c++) {
+        unsigned short* slots = filter->fingerprints + (size_t)candidates[c] * CUCKOO_FILTER_SLOTS;
+        for (int i = 0; i < CUCKOO_FILTER_SLOTS; i++) {
+            if (slots[i] == fingerprint) {
+                slots[i] = 0;
+                return 1;
+            }
         }
-        index = (index + 1) % ht->size;
-        if (index == originalIndex) {
-            break; // Table is full, key not found
+    }
+    return 0;
+}
+
+void attachChainingFilter(struct ChainingHashTable* ht, struct MembershipFilter* filter) {
+    // Loads the keys already present, then keeps the filter in step with every insert and delete
+    freeMembershipFilter(ht->filter);
+    ht->filter = filter;
+    for (int i = 0; i < ht->size; i++) {
+        if (ht->buckets) {
+            for (struct CacheLineBucket* bucket = &ht->buckets[i]; bucket; bucket = bucket->overflow) {
+                for (int k = 0; k < bucket->count; k++) {
+                    addToFilter(filter, bucket->keys[k]);
+                }
+            }
+        } else {
+            for (struct Node* node = ht->table[i]; node; node = node->next) {
+                addToFilter(filter, node->data);
+            }
         }
     }
-    
-    return 0; // Key not found
 }
 
-void printLinearProbingHashTable(struct OpenAddressingHashTable* ht) {
+void attachOpenAddressingFilter(struct OpenAddressingHashTable* ht, struct MembershipFilter* filter) {
+    freeMembershipFilter(ht->filter);
+    ht->filter = filter;
     for (int i = 0; i < ht->size; i++) {
         if (ht->table[i] != -1 && !ht->deleted[i]) {
-            printf("Index %d: %d\n", i, ht->table[i]);
-        } else if (ht->deleted[i]) {
-            printf("Index %d: Deleted\n", i);
-        } else {
-            printf("Index %d: Empty\n", i);
+            addToFilter(filter, ht->table[i]);
+        }
+    }
+    for (int i = 0; ht->oldTable && i < ht->oldSize; i++) {
+        if (ht->oldTable[i] != -1 && !ht->oldDeleted[i]) {
+            addToFilter(filter, ht->oldTable[i]);
         }
     }
 }
 
-// Quadratic Probing Implementation
-int insertQuadraticProbing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    int i = 0;
+// Statistics Implementation
+int histogramBucket(long long length) {
+    return length < STATS_HISTOGRAM_BUCKETS - 1 ? (int)length : STATS_HISTOGRAM_BUCKETS - 1;
+}
+
+void recordProbe(struct TableStats* stats, int found, long long probes) {
+    if (found) {
+        stats->hitProbes[histogramBucket(probes)]++;
+    } else {
+        stats->missProbes[histogramBucket(probes)]++;
+    }
+    if (probes > stats->longestProbe) {
+        stats->longestProbe = probes;
+    }
+}
+
+void resetTableStats(struct TableStats* stats) {
+    memset(stats, 0, sizeof(struct TableStats));
+}
+
+struct TableStats* collectChainingStats(struct ChainingHashTable* ht) {
+    struct TableStats* stats = &ht->stats;
+    stats->chaining = 1;
+    stats->keys = 0;
+    stats->slots = ht->size;
+    stats->tombstones = 0;
+    stats->longestRun = 0;
+    memset(stats->runLengths, 0, sizeof(stats->runLengths));
     
-    while (ht->table[index] != -1 && !ht->deleted[index]) {
-        if (ht->table[index] == key) {
-            return 0; // Key already exists
+    for (int i = 0; i < ht->size; i++) {
+        int length = 0;
+        if (ht->buckets) {
+            for (struct CacheLineBucket* bucket = &ht->buckets[i]; bucket; bucket = bucket->overflow) {
+                length += bucket->count;
+            }
+        } else {
+            for (struct Node* node = ht->table[i]; node; node = node->next) {
+                length++;
+            }
         }
-        i++;
-        index = (originalIndex + i * i) % ht->size;
-        if (i >= ht->size) {
-            return 0; // Table is full
+        stats->runLengths[histogramBucket(length)]++;
+        if (length > stats->longestRun) stats->longestRun = length;
+        stats->keys += length;
+    }
+    return stats;
+}
+
+struct TableStats* collectOpenAddressingStats(struct OpenAddressingHashTable* ht) {
+    // Clusters are runs of slots that are not empty; tombstones count because
+    // probes have to walk over them just the same
+    struct TableStats* stats = &ht->stats;
+    stats->chaining = 0;
+    stats->keys = ht->count;
+    stats->slots = ht->size;
+    stats->tombstones = ht->tombstones;
+    stats->longestRun = 0;
+    memset(stats->runLengths, 0, sizeof(stats->runLengths));
+    
+    // Start right after an empty slot so no cluster is split by the wrap around
+    int start = 0;
+    while (start < ht->size && (ht->table[start] != -1 || ht->deleted[start])) {
+        start++;
+    }
+    int length = 0;
+    for (int n = 1; n <= ht->size; n++) {
+        int i = (start + n) % ht->size;
+        if (ht->table[i] != -1 || ht->deleted[i]) {
+            length++;
+        } else if (length > 0) {
+            stats->runLengths[histogramBucket(length)]++;
+            if (length > stats->longestRun) stats->longestRun = length;
+            length = 0;
         }
     }
+    if (length > 0) {
+        stats->runLengths[histogramBucket(length)]++; // No empty slot at all
+        if (length > stats->longestRun) stats->longestRun = length;
+    }
+    return stats;
+}
+
+void printTableStatsJson(const struct TableStats* stats) {
+    const long long* histograms[] = { stats->hitProbes, stats->missProbes, stats->runLengths };
+    const char* names[] = { "hit_probes", "miss_probes", stats->chaining ? "chain_lengths" : "cluster_lengths" };
     
-    ht->table[index] = key;
-    ht->deleted[index] = 0;
-    return 1; // Insertion successful
+    printf("{\"keys\": %d, \"slots\": %d, \"tombstones\": %d, \"resizes\": %lld, \"rehashed_keys\": %lld, "
+           "\"longest_probe\": %lld, \"%s\": %d",
+           stats->keys, stats->slots, stats->tombstones, stats->resizes, stats->rehashedKeys,
+           stats->longestProbe, stats->chaining ? "longest_chain" : "longest_cluster", stats->longestRun);
+    // Histogram entry i counts length i, the last entry every length from there on
+    for (int h = 0; h < 3; h++) {
+        printf(", \"%s\": [", names[h]);
+        for (int i = 0; i < STATS_HISTOGRAM_BUCKETS; i++) {
+            printf(i ? ", %lld" : "%lld", histograms[h][i]);
+        }
+        printf("]");
+    }
+    printf("}");
 }
 
-int searchQuadraticProbing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    int i = 0;
+// Cache-Line Bucket Chaining Implementation
+// Every page but the last one in a bucket's overflow chain is kept full
+int insertBucketChaining(struct ChainingHashTable* ht, int index, int key) {
+    struct CacheLineBucket* bucket = &ht->buckets[index];
     
-    while (ht->table[index] != -1 || ht->deleted[index]) {
-        if (ht->table[index] == key && !ht->deleted[index]) {
-            return index; // Key found
+    while (bucket->count == BUCKET_SLOTS) {
+        if (bucket->overflow == NULL) {
+            bucket->overflow = (struct CacheLineBucket*)calloc(1, sizeof(struct CacheLineBucket));
+            ht->allocations++;
         }
-        i++;
-        index = (originalIndex + i * i) % ht->size;
-        if (i >= ht->size || index == originalIndex) {
-            return -1; // Key not found or table full
+        bucket = bucket->overflow;
+    }
+    bucket->keys[bucket->count++] = key;
+    
+    return 1; // Insertion successful
+}
+
+int searchBucketChaining(struct ChainingHashTable* ht, int index, int key) {
+    for (struct CacheLineBucket* bucket = &ht->buckets[index]; bucket; bucket = bucket->overflow) {
+        for (int i = 0; i < bucket->count; i++) {
+            probeCount++;
+            if (bucket->keys[i] == key) {
+                return index; // Key found
+            }
         }
     }
     
     return -1; // Key not found
 }
 
-int deleteQuadraticProbing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    int i = 0;
+int deleteBucketChaining(struct ChainingHashTable* ht, int index, int key) {
+    struct CacheLineBucket* bucket = &ht->buckets[index];
     
-    while (ht->table[index] != -1 || ht->deleted[index]) {
-        if (ht->table[index] == key && !ht->deleted[index]) {
-            ht->deleted[index] = 1; // Mark as deleted
+    for (struct CacheLineBucket* page = bucket; page; page = page->overflow) {
+        for (int i = 0; i < page->count; i++) {
+            if (page->keys[i] != key) {
+                continue;
+            }
+            // Fill the hole with the very last key so only the last page is ever partly empty
+            struct CacheLineBucket* prev = NULL;
+            struct CacheLineBucket* last = bucket;
+            while (last->overflow) {
+                prev = last;
+                last = last->overflow;
+            }
+            page->keys[i] = last->keys[--last->count];
+            if (last->count == 0 && prev) {
+                prev->overflow = NULL;
+                free(last);
+            }
             return 1; // Deletion successful
         }
-        i++;
-        index = (originalIndex + i * i) % ht->size;
-        if (i >= ht->size || index == originalIndex) {
-            return 0; // Key not found or table full
-        }
     }
     
     return 0; // Key not found
 }
 
-void printQuadraticProbingHashTable(struct OpenAddressingHashTable* ht) {
-    for (int i = 0; i < ht->size; i++) {
-        if (ht->table[i] != -1 && !ht->deleted[i]) {
-            printf("Index %d: %d\n", i, ht->table[i]);
-        } else if (ht->deleted[i]) {
-            printf("Index %d: Deleted\n", i);
+void printBucketChaining(struct ChainingHashTable* ht, int index) {
+    struct CacheLineBucket* bucket = &ht->buckets[index];
+    if (bucket->count == 0) {
+        printf("Empty\n");
+        return;
+    }
+    for (; bucket; bucket = bucket->overflow) {
+        for (int i = 0; i < bucket->count; i++) {
+            printf("%d", bucket->keys[i]);
+            if (i + 1 < bucket->count) printf(", ");
+        }
+        if (bucket->overflow) printf(" | "); // Next overflow page
+    }
+    printf("\n");
+}
+
+// Open Addressing Implementation
+struct OpenAddressingHashTable* createOpenAddressingHashTable(int size) {
+    return createOpenAddressingHashTableWithHash(size, HASH_DIVISION);
+}
+
+struct OpenAddressingHashTable* createOpenAddressingHashTableWithHash(int size, enum HashFunctionId hashFunction) {
+    return createResizableOpenAddressingHashTable(size, hashFunction, DEFAULT_MAX_LOAD_FACTOR, DEFAULT_MAX_TOMBSTONE_FACTOR, REHASH_BATCH);
+}
+
+struct OpenAddressingHashTable* createPowerOfTwoOpenAddressingHashTable(int size, enum HashFunctionId hashFunction) {
+    // Probes wrap with a mask instead of a modulo; growth keeps doubling from here
+    return createOpenAddressingHashTableWithHash(nextPowerOfTwo(size), hashFunction);
+}
+
+struct OpenAddressingHashTable* createResizableOpenAddressingHashTable(int size, enum HashFunctionId hashFunction, double maxLoadFactor, double maxTombstoneFactor, int rehashBatch) {
+    struct OpenAddressingHashTable* ht = (struct OpenAddressingHashTable*)malloc(sizeof(struct OpenAddressingHashTable));
+    ht->size = size;
+    ht->hashFunction = hashFunction;
+    ht->table = allocateEmptySlots(size); // -1 indicates empty slot
+    ht->deleted = (int*)calloc(size, sizeof(int)); // 0 indicates not deleted
+    
+    // Above 0.95 the probe sequences get too long to be worth keeping
+    if (maxLoadFactor > 0.95) maxLoadFactor = 0.95;
+    ht->count = 0;
+    ht->used = 0;
+    ht->tombstones = 0;
+    ht->maxLoadFactor = maxLoadFactor;
+    ht->maxTombstoneFactor = maxTombstoneFactor;
+    ht->rehashBatch = rehashBatch;
+    ht->oldSize = 0;
+    ht->oldTable = NULL;
+    ht->oldDeleted = NULL;
+    ht->rehashIndex = 0;
+    ht->filter = NULL;
+    memset(&ht->stats, 0, sizeof(ht->stats));
+    
+    return ht;
+}
+
+void freeOpenAddressingHashTable(struct OpenAddressingHashTable* ht) {
+    if (ht) {
+        free(ht->table);
+        free(ht->deleted);
+        free(ht->oldTable);
+        free(ht->oldDeleted);
+        freeMembershipFilter(ht->filter);
+        free(ht);
+    }
+}
+
+// Shared probing core used by every probe sequence.
+// Power-of-two tables wrap with a mask instead of a modulo: quadratic probing steps by
+// triangular numbers and double hashing by an odd stride, and both reach every slot
+long long probeOffset(enum ProbeSequence probe, int key, int i, int size) {
+    switch (probe) {
+        case PROBE_QUADRATIC:
+            return (long long)i * i;
+        case PROBE_DOUBLE:
+            return (long long)i * doubleHashFunction(key, size);
+        default:
+            return i;
+    }
+}
+
+int probeStride(enum ProbeSequence probe, int key, int size) {
+    // Step of a power-of-two table; odd strides share no factor with the size
+    if (probe == PROBE_DOUBLE) {
+        return (int)((mixBits((unsigned int)key) >> 32) | 1) & (size - 1);
+    }
+    return 1;
+}
+
+int displacement(int* table, int size, int index, HashFunction hash) {
+    int home = hash(table[index], size);
+    return index >= home ? index - home : index + size - home;
+}
+
+int findSlot(int* table, int* deleted, int size, int key, enum ProbeSequence probe, HashFunction hash) {
+    int index = hash(key, size);
+    int originalIndex = index;
+    int i = 0;
+    
+    if (probe == PROBE_ROBIN_HOOD) {
+        // Runs are ordered by displacement, so the key cannot be past a slot
+        // whose resident is closer to home than we are
+        for (; i < size && table[index] != -1; i++) {
+            probeCount++;
+            if (table[index] == key && !deleted[index]) {
+                return index; // Key found
+            }
+            if (displacement(table, size, index, hash) < i) {
+                break;
+            }
+            index = index + 1 == size ? 0 : index + 1;
+        }
+        return -1; // Key not found
+    }
+    
+    int mask = (size & (size - 1)) == 0 ? size - 1 : -1;
+    int stride = probeStride(probe, key, size);
+    while (table[index] != -1 || deleted[index]) {
+        probeCount++;
+        if (table[index] == key && !deleted[index]) {
+            return index; // Key found
+        }
+        i++;
+        if (mask >= 0) {
+            index = (index + (probe == PROBE_QUADRATIC ? i : stride)) & mask;
+        } else {
+            index = (int)((originalIndex + probeOffset(probe, key, i, size)) % size);
+        }
+        if (i >= size || index == originalIndex) {
+            break; // Whole probe sequence visited
+        }
+    }
+    
+    return -1; // Key not found
+}
+
+int placeKey(int* table, int* deleted, int size, int key, enum ProbeSequence probe, HashFunction hash) {
+    int index = hash(key, size);
+    int originalIndex = index;
+    int firstFree = -1;
+    
+    if (probe == PROBE_ROBIN_HOOD) {
+        for (int i = 0; i < size; i++) {
+            probeCount++;
+            if (table[index] == -1) {
+                return index;
+            }
+            if (table[index] == key) {
+                return PLACE_DUPLICATE;
+            }
+            if (displacement(table, size, index, hash) < i) {
+                // Take this slot from the richer resident; it only pays off
+                // if there is an empty slot left to shift the run into
+                for (int j = i, end = index; j < size; j++) {
+                    if (table[end] == -1) return index;
+                    end = end + 1 == size ? 0 : end + 1;
+                }
+                return -1; // Table is full
+            }
+            index = index + 1 == size ? 0 : index + 1;
+        }
+        return -1; // Table is full
+    }
+    
+    // Keep walking past tombstones so a key further down the sequence is not inserted twice
+    int mask = (size & (size - 1)) == 0 ? size - 1 : -1;
+    int stride = probeStride(probe, key, size);
+    for (int i = 0; i < size; ) {
+        probeCount++;
+        if (deleted[index]) {
+            if (firstFree == -1) firstFree = index;
+        } else if (table[index] == -1) {
+            return firstFree != -1 ? firstFree : index;
+        } else if (table[index] == key) {
+            return PLACE_DUPLICATE;
+        }
+        i++;
+        if (mask >= 0) {
+            index = (index + (probe == PROBE_QUADRATIC ? i : stride)) & mask;
+        } else {
+            index = (int)((originalIndex + probeOffset(probe, key, i, size)) % size);
+        }
+    }
+    
+    return firstFree; // -1 when the probe sequence is full
+}
+
+int writeKey(int* table, int* deleted, int size, int slot, int key, enum ProbeSequence probe) {
+    // Returns 1 when an empty slot was used up, 0 when a tombstone was reused
+    if (deleted[slot]) {
+        table[slot] = key;
+        deleted[slot] = 0;
+        return 0;
+    }
+    if (probe == PROBE_ROBIN_HOOD && table[slot] != -1) {
+        // Every resident from slot to the next empty slot moves one step further from home
+        int end = slot;
+        while (table[end] != -1) {
+            end = end + 1 == size ? 0 : end + 1;
+        }
+        while (end != slot) {
+            int prev = end == 0 ? size - 1 : end - 1;
+            table[end] = table[prev];
+            end = prev;
+        }
+    }
+    table[slot] = key;
+    return 1;
+}
+
+void backwardShiftDelete(int* table, int size, int index, HashFunction hash) {
+    // Pull the rest of the run one step closer to home instead of leaving a tombstone
+    int next = index + 1 == size ? 0 : index + 1;
+    while (table[next] != -1 && displacement(table, size, next, hash) > 0) {
+        table[index] = table[next];
+        index = next;
+        next = next + 1 == size ? 0 : next + 1;
+    }
+    table[index] = -1;
+}
+
+// Resizing Implementation
+int nextPrime(int n) {
+    if (n < 2) return 2;
+    for (;; n++) {
+        int isPrime = 1;
+        for (int d = 2; (long long)d * d <= n; d++) {
+            if (n % d == 0) {
+                isPrime = 0;
+                break;
+            }
+        }
+        if (isPrime) return n;
+    }
+}
+
+int nextPowerOfTwo(int n) {
+    int power = 1;
+    while (power < n && power <= INT_MAX / 2) {
+        power *= 2;
+    }
+    return power;
+}
+
+int nextTableSize(int size) {
+    // Power-of-two tables stay powers of two so they keep their mask indexing
+    if ((size & (size - 1)) == 0) {
+        return size * 2;
+    }
+    return nextPrime(size * 2);
+}
+
+int* allocateEmptySlots(int size) {
+    // memset and calloc are much cheaper than a per-slot loop on large tables,
+    // which matters because this runs inside the insert that starts a rehash
+    int* slots = (int*)malloc(size * sizeof(int));
+    if (slots) {
+        memset(slots, 0xFF, size * sizeof(int)); // Every byte 0xFF is -1
+    }
+    return slots;
+}
+
+int needsRehash(struct OpenAddressingHashTable* ht) {
+    if (ht->maxLoadFactor <= 0) {
+        return 0; // Fixed capacity
+    }
+    return ht->used + 1 > ht->maxLoadFactor * ht->size ||
+           ht->tombstones > ht->maxTombstoneFactor * ht->size;
+}
+
+int growCurrentTable(struct OpenAddressingHashTable* ht, enum ProbeSequence probe) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    // Synchronous fallback for a probe sequence that ran out of slots; the old
+    // table of an in-progress rehash is left alone and keeps migrating as usual
+    int newSize = ht->size;
+    for (;;) {
+        if (newSize > INT_MAX / 2 - 1) {
+            return 0; // Cannot grow any further
+        }
+        newSize = nextTableSize(newSize);
+        int* newTable = allocateEmptySlots(newSize);
+        int* newDeleted = (int*)calloc(newSize, sizeof(int));
+        if (newTable == NULL || newDeleted == NULL) {
+            free(newTable);
+            free(newDeleted);
+            return 0;
+        }
+        
+        int placed = 1, moved = 0;
+        for (int i = 0; i < ht->size && placed; i++) {
+            if (ht->table[i] != -1 && !ht->deleted[i]) {
+                int slot = placeKey(newTable, newDeleted, newSize, ht->table[i], probe, hash);
+                if (slot < 0) {
+                    placed = 0;
+                } else {
+                    writeKey(newTable, newDeleted, newSize, slot, ht->table[i], probe);
+                    moved++;
+                }
+            }
+        }
+        if (!placed) {
+            free(newTable);
+            free(newDeleted);
+            continue;
+        }
+        
+        free(ht->table);
+        free(ht->deleted);
+        ht->table = newTable;
+        ht->deleted = newDeleted;
+        ht->used -= ht->tombstones;
+        ht->tombstones = 0;
+        ht->size = newSize;
+        ht->stats.resizes++;
+        ht->stats.rehashedKeys += moved;
+        return 1;
+    }
+}
+
+void moveOldSlot(struct OpenAddressingHashTable* ht, int oldIndex, enum ProbeSequence probe) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    if (ht->oldTable[oldIndex] == -1 || ht->oldDeleted[oldIndex]) {
+        return;
+    }
+    int slot = placeKey(ht->table, ht->deleted, ht->size, ht->oldTable[oldIndex], probe, hash);
+    while (slot == -1 && growCurrentTable(ht, probe)) {
+        slot = placeKey(ht->table, ht->deleted, ht->size, ht->oldTable[oldIndex], probe, hash);
+    }
+    if (slot < 0) {
+        return; // Out of memory
+    }
+    if (writeKey(ht->table, ht->deleted, ht->size, slot, ht->oldTable[oldIndex], probe)) {
+        ht->used++;
+    } else {
+        ht->tombstones--;
+    }
+    ht->oldDeleted[oldIndex] = 1;
+    ht->stats.rehashedKeys++;
+}
+
+void rehashStep(struct OpenAddressingHashTable* ht, enum ProbeSequence probe) {
+    if (ht->oldTable == NULL) {
+        return;
+    }
+    int end = ht->rehashBatch > 0 ? ht->rehashIndex + ht->rehashBatch : ht->oldSize;
+    if (end > ht->oldSize) end = ht->oldSize;
+    
+    for (; ht->rehashIndex < end; ht->rehashIndex++) {
+        moveOldSlot(ht, ht->rehashIndex, probe);
+    }
+    
+    if (ht->rehashIndex == ht->oldSize) {
+        free(ht->oldTable);
+        free(ht->oldDeleted);
+        ht->oldTable = NULL;
+        ht->oldDeleted = NULL;
+        ht->oldSize = 0;
+    }
+}
+
+void finishRehash(struct OpenAddressingHashTable* ht, enum ProbeSequence probe) {
+    int batch = ht->rehashBatch;
+    ht->rehashBatch = 0;
+    rehashStep(ht, probe);
+    ht->rehashBatch = batch;
+}
+
+int startRehash(struct OpenAddressingHashTable* ht, enum ProbeSequence probe) {
+    finishRehash(ht, probe);
+    
+    // Grow when live keys alone would keep the table above half its load limit,
+    // otherwise rebuild at the same size to flush tombstones
+    int newSize = ht->size;
+    if ((ht->count + 1) * 2.0 > ht->maxLoadFactor * ht->size) {
+        if (ht->size > INT_MAX / 2 - 1) {
+            return 0; // Cannot grow any further
+        }
+        newSize = nextTableSize(ht->size);
+    }
+    
+    int* newTable = allocateEmptySlots(newSize);
+    int* newDeleted = (int*)calloc(newSize, sizeof(int));
+    if (newTable == NULL || newDeleted == NULL) {
+        free(newTable);
+        free(newDeleted);
+        return 0;
+    }
+    
+    ht->oldTable = ht->table;
+    ht->oldDeleted = ht->deleted;
+    ht->oldSize = ht->size;
+    ht->rehashIndex = 0;
+    ht->table = newTable;
+    ht->deleted = newDeleted;
+    ht->size = newSize;
+    ht->used = 0;
+    ht->tombstones = 0;
+    ht->stats.resizes++;
+    
+    rehashStep(ht, probe);
+    return 1;
+}
+
+int insertOpenAddressing(struct OpenAddressingHashTable* ht, int key, enum ProbeSequence probe) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    rehashStep(ht, probe);
+    if (needsRehash(ht)) {
+        startRehash(ht, probe);
+    }
+    if (ht->oldTable && findSlot(ht->oldTable, ht->oldDeleted, ht->oldSize, key, probe, hash) != -1) {
+        return 0; // Key already exists
+    }
+    
+    int slot = placeKey(ht->table, ht->deleted, ht->size, key, probe, hash);
+    // Quadratic and double hashing may not reach every slot, so a full probe
+    // sequence can happen below the load limit; grow and retry in that case
+    while (slot == -1 && ht->maxLoadFactor > 0 && growCurrentTable(ht, probe)) {
+        slot = placeKey(ht->table, ht->deleted, ht->size, key, probe, hash);
+    }
+    if (slot < 0) {
+        return 0; // Key already exists or table is full
+    }
+    
+    if (writeKey(ht->table, ht->deleted, ht->size, slot, key, probe)) {
+        ht->used++;
+    } else {
+        ht->tombstones--;
+    }
+    ht->count++;
+    if (ht->filter) {
+        addToFilter(ht->filter, key);
+    }
+    return 1; // Insertion successful
+}
+
+int searchOpenAddressing(struct OpenAddressingHashTable* ht, int key, enum ProbeSequence probe) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    if (ht->filter && !mayContain(ht->filter, key)) {
+        return -1; // Key not found
+    }
+    rehashStep(ht, probe);
+    long long before = probeCount;
+    int index = findSlot(ht->table, ht->deleted, ht->size, key, probe, hash);
+    if (index != -1 || ht->oldTable == NULL) {
+        recordProbe(&ht->stats, index != -1, probeCount - before);
+        return index;
+    }
+    
+    // Still waiting in the old table: migrate it now so the returned index is in the live table
+    int oldIndex = findSlot(ht->oldTable, ht->oldDeleted, ht->oldSize, key, probe, hash);
+    recordProbe(&ht->stats, oldIndex != -1, probeCount - before);
+    if (oldIndex == -1) {
+        return -1; // Key not found
+    }
+    moveOldSlot(ht, oldIndex, probe);
+    return findSlot(ht->table, ht->deleted, ht->size, key, probe, hash);
+}
+
+int deleteOpenAddressing(struct OpenAddressingHashTable* ht, int key, enum ProbeSequence probe) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    rehashStep(ht, probe);
+    int index = findSlot(ht->table, ht->deleted, ht->size, key, probe, hash);
+    if (index != -1 && ht->filter) {
+        removeFromFilter(ht->filter, key);
+    }
+    if (index != -1 && probe == PROBE_ROBIN_HOOD) {
+        backwardShiftDelete(ht->table, ht->size, index, hash);
+        ht->used--;
+        ht->count--;
+        return 1; // Deletion successful
+    }
+    if (index != -1) {
+        ht->deleted[index] = 1; // Mark as deleted
+        ht->tombstones++;
+        ht->count--;
+        if (needsRehash(ht)) {
+            startRehash(ht, probe); // Compact away the tombstones
+        }
+        return 1; // Deletion successful
+    }
+    
+    if (ht->oldTable) {
+        // The old table is tombstoned even for Robin Hood: shifting it would
+        // pull keys behind rehashIndex before they are migrated
+        int oldIndex = findSlot(ht->oldTable, ht->oldDeleted, ht->oldSize, key, probe, hash);
+        if (oldIndex != -1) {
+            ht->oldDeleted[oldIndex] = 1;
+            ht->count--;
+            if (ht->filter) {
+                removeFromFilter(ht->filter, key);
+            }
+            return 1; // Deletion successful
+        }
+    }
+    
+    return 0; // Key not found
+}
+
+void printOpenAddressingHashTable(struct OpenAddressingHashTable* ht) {
+    for (int i = 0; i < ht->size; i++) {
+        if (ht->table[i] != -1 && !ht->deleted[i]) {
+            printf("Index %d: %d\n", i, ht->table[i]);
+        } else if (ht->deleted[i]) {
+            printf("Index %d: Deleted\n", i);
         } else {
             printf("Index %d: Empty\n", i);
         }
     }
+    if (ht->oldTable) {
+        printf("Rehashing: %d of %d old slots migrated\n", ht->rehashIndex, ht->oldSize);
+    }
+}
+
+// Batch Implementation
+// Each block first hashes every key and prefetches its home slot, then resolves the
+// keys one by one, so the cache misses of a whole block overlap instead of queueing
+void prefetchOpenAddressingSlots(struct OpenAddressingHashTable* ht, const int* keys, int count) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    for (int i = 0; i < count; i++) {
+        int home = hash(keys[i], ht->size);
+        PREFETCH(&ht->table[home]);
+        PREFETCH(&ht->deleted[home]);
+    }
+}
+
+void insertBatchOpenAddressing(struct OpenAddressingHashTable* ht, const int* keys, int count, int* results, enum ProbeSequence probe) {
+    for (int start = 0; start < count; start += PREFETCH_BLOCK) {
+        int end = start + PREFETCH_BLOCK < count ? start + PREFETCH_BLOCK : count;
+        prefetchOpenAddressingSlots(ht, keys + start, end - start);
+        for (int i = start; i < end; i++) {
+            results[i] = insertOpenAddressing(ht, keys[i], probe);
+        }
+    }
+}
+
+void searchBatchOpenAddressing(struct OpenAddressingHashTable* ht, const int* keys, int count, int* results, enum ProbeSequence probe) {
+    for (int start = 0; start < count; start += PREFETCH_BLOCK) {
+        int end = start + PREFETCH_BLOCK < count ? start + PREFETCH_BLOCK : count;
+        prefetchOpenAddressingSlots(ht, keys + start, end - start);
+        for (int i = start; i < end; i++) {
+            results[i] = searchOpenAddressing(ht, keys[i], probe);
+        }
+    }
+}
+
+void deleteBatchOpenAddressing(struct OpenAddressingHashTable* ht, const int* keys, int count, int* results, enum ProbeSequence probe) {
+    for (int start = 0; start < count; start += PREFETCH_BLOCK) {
+        int end = start + PREFETCH_BLOCK < count ? start + PREFETCH_BLOCK : count;
+        prefetchOpenAddressingSlots(ht, keys + start, end - start);
+        for (int i = start; i < end; i++) {
+            results[i] = deleteOpenAddressing(ht, keys[i], probe);
+        }
+    }
+}
+
+void prefetchChainingBuckets(struct ChainingHashTable* ht, const int* keys, int count) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    int indexes[PREFETCH_BLOCK];
+    
+    for (int i = 0; i < count; i++) {
+        indexes[i] = hash(keys[i], ht->size);
+        if (ht->buckets) {
+            PREFETCH(&ht->buckets[indexes[i]]);
+        } else {
+            PREFETCH(&ht->table[indexes[i]]);
+        }
+    }
+    if (ht->buckets) {
+        return; // The bucket line already holds the first BUCKET_SLOTS keys
+    }
+    // Second wave: the bucket heads are arriving, so the first node of each chain can be requested too
+    for (int i = 0; i < count; i++) {
+        struct Node* head = ht->table[indexes[i]];
+        if (head) {
+            PREFETCH(head);
+        }
+    }
+}
+
+void insertBatchChaining(struct ChainingHashTable* ht, const int* keys, int count, int* results) {
+    for (int start = 0; start < count; start += PREFETCH_BLOCK) {
+        int end = start + PREFETCH_BLOCK < count ? start + PREFETCH_BLOCK : count;
+        prefetchChainingBuckets(ht, keys + start, end - start);
+        for (int i = start; i < end; i++) {
+            results[i] = insertChaining(ht, keys[i]);
+        }
+    }
+}
+
+void searchBatchChaining(struct ChainingHashTable* ht, const int* keys, int count, int* results) {
+    for (int start = 0; start < count; start += PREFETCH_BLOCK) {
+        int end = start + PREFETCH_BLOCK < count ? start + PREFETCH_BLOCK : count;
+        prefetchChainingBuckets(ht, keys + start, end - start);
+        for (int i = start; i < end; i++) {
+            results[i] = searchChaining(ht, keys[i]);
+        }
+    }
+}
+
+void deleteBatchChaining(struct ChainingHashTable* ht, const int* keys, int count, int* results) {
+    for (int start = 0; start < count; start += PREFETCH_BLOCK) {
+        int end = start + PREFETCH_BLOCK < count ? start + PREFETCH_BLOCK : count;
+        prefetchChainingBuckets(ht, keys + start, end - start);
+        for (int i = start; i < end; i++) {
+            results[i] = deleteChaining(ht, keys[i]);
+        }
+    }
+}
+
+// Sharded Table Implementation
+int numaNodeCount(void) {
+#ifdef __linux__
+    char path[64];
+    int count = 0;
+    while (count < MAX_NUMA_NODES) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", count);
+        if (access(path, F_OK) != 0) {
+            break;
+        }
+        count++;
+    }
+    return count > 0 ? count : 1;
+#else
+    return 1;
+#endif
+}
+
+int bindToNumaNode(void* address, size_t length, int node) {
+    // Prefers node for the pages under [address, address + length) and moves the ones already
+    // touched; whole pages are bound, so a neighbouring allocation sharing a page moves too
+#ifdef __linux__
+    if (address == NULL || length == 0 || node < 0 || node >= MAX_NUMA_NODES) {
+        return 0;
+    }
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = (size_t)address & ~(page - 1);
+    size_t end = ((size_t)address + length + page - 1) & ~(page - 1);
+    unsigned long long mask = 1ULL << node;
+    // The kernel drops the last bit of maxnode, hence the + 1
+    return syscall(SYS_mbind, (void*)start, end - start, MPOL_PREFERRED, &mask, MAX_NUMA_NODES + 1, MPOL_MF_MOVE) == 0;
+#else
+    (void)address;
+    (void)length;
+    (void)node;
+    return 0;
+#endif
+}
+
+int pinThreadToNumaNode(int node) {
+#ifdef __linux__
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    // CPUs and ranges separated by commas, e.g. "0-15,32-47"
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    int first, last;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        int separator = fgetc(file);
+        if (separator == '-') {
+            if (fscanf(file, "%d", &last) != 1) break;
+            separator = fgetc(file);
+        }
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, &cpus);
+        }
+        if (separator != ',') break;
+    }
+    fclose(file);
+    return CPU_COUNT(&cpus) > 0 && sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+    (void)node;
+    return 0;
+#endif
+}
+
+struct ShardedHashTable* createShardedHashTable(int shardCount, int shardSize, enum CollisionStrategy strategy, enum HashFunctionId hashFunction, const int* shardNodes) {
+    struct ShardedHashTable* ht = (struct ShardedHashTable*)malloc(sizeof(struct ShardedHashTable));
+    int nodeCount = numaNodeCount();
+    ht->shardCount = shardCount;
+    ht->probe = strategy == STRATEGY_QUADRATIC_PROBING ? PROBE_QUADRATIC :
+                strategy == STRATEGY_DOUBLE_HASHING ? PROBE_DOUBLE : PROBE_LINEAR;
+    ht->chainingShards = NULL;
+    ht->openShards = NULL;
+    if (strategy == STRATEGY_CHAINING) {
+        ht->chainingShards = (struct ChainingHashTable**)malloc(shardCount * sizeof(struct ChainingHashTable*));
+    } else {
+        ht->openShards = (struct OpenAddressingHashTable**)malloc(shardCount * sizeof(struct OpenAddressingHashTable*));
+    }
+    ht->shardNodes = (int*)malloc(shardCount * sizeof(int));
+    ht->boundMemory = (void**)calloc(shardCount, sizeof(void*));
+    ht->bindFailures = 0;
+    memset(&ht->stats, 0, sizeof(ht->stats));
+    
+    for (int s = 0; s < shardCount; s++) {
+        // Without a placement the shards are spread round robin, unless there is only one node
+        ht->shardNodes[s] = shardNodes ? shardNodes[s] : nodeCount > 1 ? s % nodeCount : -1;
+        if (ht->chainingShards) {
+            // Pooled, so the nodes sit in slabs that can be bound as a whole
+            ht->chainingShards[s] = createPooledChainingHashTable(shardSize, hashFunction);
+            if (ht->shardNodes[s] >= 0 &&
+                !bindToNumaNode(ht->chainingShards[s]->table, shardSize * sizeof(struct Node*), ht->shardNodes[s])) {
+                ht->bindFailures++;
+            }
+        } else {
+            ht->openShards[s] = createOpenAddressingHashTableWithHash(shardSize, hashFunction);
+        }
+        bindShardMemory(ht, s);
+    }
+    
+    return ht;
+}
+
+void freeShardedHashTable(struct ShardedHashTable* ht) {
+    if (ht) {
+        for (int s = 0; s < ht->shardCount; s++) {
+            if (ht->chainingShards) freeChainingHashTable(ht->chainingShards[s]);
+            else freeOpenAddressingHashTable(ht->openShards[s]);
+        }
+        free(ht->chainingShards);
+        free(ht->openShards);
+        free(ht->shardNodes);
+        free(ht->boundMemory);
+        free(ht);
+    }
+}
+
+void bindShardMemory(struct ShardedHashTable* ht, int shard) {
+    // Shards allocate as they grow, so bind whatever memory appeared since the last call
+    int node = ht->shardNodes[shard];
+    if (node < 0) {
+        return;
+    }
+    if (ht->openShards) {
+        struct OpenAddressingHashTable* table = ht->openShards[shard];
+        if (table->table != ht->boundMemory[shard]) {
+            ht->bindFailures += !bindToNumaNode(table->table, table->size * sizeof(int), node);
+            ht->bindFailures += !bindToNumaNode(table->deleted, table->size * sizeof(int), node);
+            ht->boundMemory[shard] = table->table;
+        }
+    } else {
+        struct NodeSlab* slab = ht->chainingShards[shard]->pool->slabs;
+        if (slab != NULL && slab != ht->boundMemory[shard]) {
+            ht->bindFailures += !bindToNumaNode(slab, sizeof(struct NodeSlab) + slab->capacity * sizeof(struct Node), node);
+            ht->boundMemory[shard] = slab;
+        }
+    }
+}
+
+int shardForKey(struct ShardedHashTable* ht, int key) {
+    // High bits of a salted mix, so keys within a shard still look random to the shard's own hash
+    return reduceToRange(mixBits((unsigned int)key ^ SHARD_ROUTE_SALT), ht->shardCount);
+}
+
+int insertSharded(struct ShardedHashTable* ht, int key) {
+    int shard = shardForKey(ht, key);
+    int inserted = ht->openShards ? insertOpenAddressing(ht->openShards[shard], key, ht->probe)
+                                  : insertChaining(ht->chainingShards[shard], key);
+    bindShardMemory(ht, shard);
+    return inserted;
+}
+
+int searchSharded(struct ShardedHashTable* ht, int key) {
+    // Returns the index inside the key's shard
+    int shard = shardForKey(ht, key);
+    return ht->openShards ? searchOpenAddressing(ht->openShards[shard], key, ht->probe)
+                          : searchChaining(ht->chainingShards[shard], key);
+}
+
+int deleteSharded(struct ShardedHashTable* ht, int key) {
+    int shard = shardForKey(ht, key);
+    int deleted = ht->openShards ? deleteOpenAddressing(ht->openShards[shard], key, ht->probe)
+                                 : deleteChaining(ht->chainingShards[shard], key);
+    bindShardMemory(ht, shard); // A delete can rehash to flush tombstones, which allocates new arrays
+    return deleted;
+}
+
+struct TableStats* collectShardedStats(struct ShardedHashTable* ht) {
+    struct TableStats* total = &ht->stats;
+    resetTableStats(total);
+    total->chaining = ht->chainingShards != NULL;
+    for (int s = 0; s < ht->shardCount; s++) {
+        const struct TableStats* shard = ht->chainingShards ? collectChainingStats(ht->chainingShards[s])
+                                                            : collectOpenAddressingStats(ht->openShards[s]);
+        for (int i = 0; i < STATS_HISTOGRAM_BUCKETS; i++) {
+            total->hitProbes[i] += shard->hitProbes[i];
+            total->missProbes[i] += shard->missProbes[i];
+            total->runLengths[i] += shard->runLengths[i];
+        }
+        if (shard->longestProbe > total->longestProbe) total->longestProbe = shard->longestProbe;
+        if (shard->longestRun > total->longestRun) total->longestRun = shard->longestRun;
+        total->resizes += shard->resizes;
+        total->rehashedKeys += shard->rehashedKeys;
+        total->keys += shard->keys;
+        total->slots += shard->slots;
+        total->tombstones += shard->tombstones;
+    }
+    return total;
+}
+
+// Bulk Build Implementation
+int bulkPartition(int home, int size, int partitionCount) {
+    return (int)((long long)home * partitionCount / size);
+}
+
+int partitionFirstSlot(int partition, int size, int partitionCount) {
+    // Smallest home that bulkPartition maps to partition
+    return (int)(((long long)partition * size + partitionCount - 1) / partitionCount);
+}
+
+void* runBulkBuildWork(void* arg) {
+    struct BulkBuildWork* work = (struct BulkBuildWork*)arg;
+    if (work->phase != BULK_BUILD) {
+        int begin = (int)((long long)work->count * work->thread / work->threadCount);
+        int end = (int)((long long)work->count * (work->thread + 1) / work->threadCount);
+        for (int i = begin; i < end; i++) {
+            int partition = bulkPartition(work->hash(work->keys[i], work->size), work->size, work->partitionCount);
+            if (work->phase == BULK_COUNT) {
+                work->cursors[partition]++;
+            } else {
+                work->partitioned[work->cursors[partition]++] = work->keys[i];
+            }
+        }
+        return NULL;
+    }
+    
+    for (int p = work->thread; p < work->partitionCount; p += work->threadCount) {
+        int first = work->partitionStart[p];
+        int last = work->partitionStart[p + 1];
+        if (work->buckets) {
+            for (int i = first; i < last; i++) {
+                struct Node* node = &work->nodes[i];
+                int index = work->hash(work->partitioned[i], work->size);
+                node->data = work->partitioned[i];
+                node->next = work->buckets[index];
+                work->buckets[index] = node;
+            }
+            continue;
+        }
+        
+        // Linear probing confined to the partition's slots; a key whose run reaches
+        // the end of the range waits for the serial pass, which can probe past it
+        int end = partitionFirstSlot(p + 1, work->size, work->partitionCount);
+        int overflow = 0;
+        for (int i = first; i < last; i++) {
+            int key = work->partitioned[i];
+            int slot = work->hash(key, work->size);
+            while (slot < end && work->table[slot] != -1 && work->table[slot] != key) {
+                slot++;
+            }
+            if (slot == end) {
+                work->partitioned[first + overflow++] = key;
+            } else if (work->table[slot] == -1) {
+                work->table[slot] = key;
+                work->placed++;
+            }
+        }
+        work->overflowCounts[p] = overflow;
+    }
+    return NULL;
+}
+
+void runBulkBuildPhase(struct BulkBuildWork* work, int threadCount, enum BulkBuildPhase phase) {
+    pthread_t* threads = (pthread_t*)malloc(threadCount * sizeof(pthread_t));
+    for (int t = 0; t < threadCount; t++) {
+        work[t].phase = phase;
+        pthread_create(&threads[t], NULL, runBulkBuildWork, &work[t]);
+    }
+    for (int t = 0; t < threadCount; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+}
+
+struct BulkBuildWork* partitionBulkKeys(const int* keys, int count, HashFunction hash, int size, int threadCount) {
+    int partitionCount = threadCount * BULK_PARTITIONS_PER_THREAD;
+    struct BulkBuildWork* work = (struct BulkBuildWork*)calloc(threadCount, sizeof(struct BulkBuildWork));
+    int* partitioned = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    int* partitionStart = (int*)malloc((partitionCount + 1) * sizeof(int));
+    int* overflowCounts = (int*)calloc(partitionCount, sizeof(int));
+    int* cursors = (int*)calloc(threadCount * partitionCount, sizeof(int));
+    
+    hash(0, size); // Universal hashing draws its parameters on the first call, which must not race
+    for (int t = 0; t < threadCount; t++) {
+        work[t].thread = t;
+        work[t].threadCount = threadCount;
+        work[t].partitionCount = partitionCount;
+        work[t].keys = keys;
+        work[t].count = count;
+        work[t].hash = hash;
+        work[t].size = size;
+        work[t].partitioned = partitioned;
+        work[t].partitionStart = partitionStart;
+        work[t].cursors = cursors + t * partitionCount;
+        work[t].overflowCounts = overflowCounts;
+    }
+    runBulkBuildPhase(work, threadCount, BULK_COUNT);
+    
+    // Each thread gets its own stretch of every partition, so no two threads write the same index
+    int offset = 0;
+    for (int p = 0; p < partitionCount; p++) {
+        partitionStart[p] = offset;
+        for (int t = 0; t < threadCount; t++) {
+            int keysInPartition = work[t].cursors[p];
+            work[t].cursors[p] = offset;
+            offset += keysInPartition;
+        }
+    }
+    partitionStart[partitionCount] = offset;
+    runBulkBuildPhase(work, threadCount, BULK_SCATTER);
+    return work;
+}
+
+void freeBulkBuildWork(struct BulkBuildWork* work) {
+    free(work[0].partitioned);
+    free(work[0].partitionStart);
+    free(work[0].cursors);
+    free(work[0].overflowCounts);
+    free(work);
+}
+
+struct OpenAddressingHashTable* bulkBuildOpenAddressing(const int* keys, int count, enum HashFunctionId hashFunction, enum ProbeSequence probe, int threadCount) {
+    // Load 0.5 leaves room for inserts before the first rehash; duplicate keys are stored once
+    int size = nextPrime((int)(count * 2.0) + 1);
+    struct OpenAddressingHashTable* ht = createOpenAddressingHashTableWithHash(size, hashFunction);
+    if (probe != PROBE_LINEAR) {
+        // The other sequences jump between partitions, so they are inserted one by one
+        for (int i = 0; i < count; i++) {
+            insertOpenAddressing(ht, keys[i], probe);
+        }
+        return ht;
+    }
+    if (threadCount < 1) threadCount = 1;
+    
+    struct BulkBuildWork* work = partitionBulkKeys(keys, count, hashFunctions[hashFunction].function, size, threadCount);
+    for (int t = 0; t < threadCount; t++) {
+        work[t].table = ht->table;
+    }
+    runBulkBuildPhase(work, threadCount, BULK_BUILD);
+    for (int t = 0; t < threadCount; t++) {
+        ht->count += work[t].placed;
+    }
+    ht->used = ht->count;
+    for (int p = 0; p < work[0].partitionCount; p++) {
+        for (int i = 0; i < work[0].overflowCounts[p]; i++) {
+            insertOpenAddressing(ht, work[0].partitioned[work[0].partitionStart[p] + i], PROBE_LINEAR);
+        }
+    }
+    freeBulkBuildWork(work);
+    return ht;
+}
+
+struct ChainingHashTable* bulkBuildChaining(const int* keys, int count, enum HashFunctionId hashFunction, int threadCount) {
+    // One bucket per key, and every node comes from a single slab owned by the table's pool.
+    // Like insertChaining, duplicate keys get a node each
+    struct ChainingHashTable* ht = createPooledChainingHashTable(count > 0 ? count : 1, hashFunction);
+    struct NodeSlab* slab = (struct NodeSlab*)malloc(sizeof(struct NodeSlab) + count * sizeof(struct Node));
+    slab->next = NULL;
+    slab->capacity = count;
+    slab->used = count;
+    ht->pool->slabs = slab;
+    ht->allocations++;
+    if (threadCount < 1) threadCount = 1;
+    
+    struct BulkBuildWork* work = partitionBulkKeys(keys, count, hashFunctions[hashFunction].function, ht->size, threadCount);
+    for (int t = 0; t < threadCount; t++) {
+        work[t].buckets = ht->table;
+        work[t].nodes = slab->nodes;
+    }
+    runBulkBuildPhase(work, threadCount, BULK_BUILD);
+    freeBulkBuildWork(work);
+    return ht;
+}
+
+// Linear Probing Implementation
+int insertLinearProbing(struct OpenAddressingHashTable* ht, int key) {
+    return insertOpenAddressing(ht, key, PROBE_LINEAR);
+}
+
+int searchLinearProbing(struct OpenAddressingHashTable* ht, int key) {
+    return searchOpenAddressing(ht, key, PROBE_LINEAR);
+}
+
+int deleteLinearProbing(struct OpenAddressingHashTable* ht, int key) {
+    return deleteOpenAddressing(ht, key, PROBE_LINEAR);
+}
+
+void printLinearProbingHashTable(struct OpenAddressingHashTable* ht) {
+    printOpenAddressingHashTable(ht);
+}
+
+// Quadratic Probing Implementation
+int insertQuadraticProbing(struct OpenAddressingHashTable* ht, int key) {
+    return insertOpenAddressing(ht, key, PROBE_QUADRATIC);
+}
+
+int searchQuadraticProbing(struct OpenAddressingHashTable* ht, int key) {
+    return searchOpenAddressing(ht, key, PROBE_QUADRATIC);
+}
+
+int deleteQuadraticProbing(struct OpenAddressingHashTable* ht, int key) {
+    return deleteOpenAddressing(ht, key, PROBE_QUADRATIC);
+}
+
+void printQuadraticProbingHashTable(struct OpenAddressingHashTable* ht) {
+    printOpenAddressingHashTable(ht);
+}
+
+// Double Hashing Implementation
+int doubleHashFunction(int key, int size) {
+    return PRIME - (key % PRIME);
+}
+
+int insertDoubleHashing(struct OpenAddressingHashTable* ht, int key) {
+    return insertOpenAddressing(ht, key, PROBE_DOUBLE);
+}
+
+int searchDoubleHashing(struct OpenAddressingHashTable* ht, int key) {
+    return searchOpenAddressing(ht, key, PROBE_DOUBLE);
+}
+
+int deleteDoubleHashing(struct OpenAddressingHashTable* ht, int key) {
+    return deleteOpenAddressing(ht, key, PROBE_DOUBLE);
+}
+
+void printDoubleHashingHashTable(struct OpenAddressingHashTable* ht) {
+    printOpenAddressingHashTable(ht);
+}
+
+// Robin Hood Hashing Implementation
+int insertRobinHood(struct OpenAddressingHashTable* ht, int key) {
+    return insertOpenAddressing(ht, key, PROBE_ROBIN_HOOD);
+}
+
+int searchRobinHood(struct OpenAddressingHashTable* ht, int key) {
+    return searchOpenAddressing(ht, key, PROBE_ROBIN_HOOD);
+}
+
+int deleteRobinHood(struct OpenAddressingHashTable* ht, int key) {
+    return deleteOpenAddressing(ht, key, PROBE_ROBIN_HOOD);
+}
+
+void printRobinHoodHashTable(struct OpenAddressingHashTable* ht) {
+    for (int i = 0; i < ht->size; i++) {
+        if (ht->table[i] != -1) {
+            printf("Index %d: %d (displacement %d)\n", i, ht->table[i], displacement(ht->table, ht->size, i, hashFunctions[ht->hashFunction].function));
+        } else {
+            printf("Index %d: Empty\n", i);
+        }
+    }
+    if (ht->oldTable) {
+        printf("Rehashing: %d of %d old slots migrated\n", ht->rehashIndex, ht->oldSize);
+    }
+}
+
+// Concurrent Chaining Implementation
+struct ConcurrentChainingHashTable* createConcurrentChainingHashTable(int size, enum HashFunctionId hashFunction) {
+    struct ConcurrentChainingHashTable* ht = (struct ConcurrentChainingHashTable*)malloc(sizeof(struct ConcurrentChainingHashTable));
+    ht->size = size;
+    ht->hashFunction = hashFunction;
+    ht->table = (_Atomic(struct ConcurrentNode*)*)malloc(size * sizeof(*ht->table));
+    
+    for (int i = 0; i < size; i++) {
+        atomic_init(&ht->table[i], NULL);
+    }
+    for (int i = 0; i < LOCK_STRIPES; i++) {
+        pthread_mutex_init(&ht->stripes[i], NULL);
+    }
+    for (int i = 0; i < MAX_READER_THREADS; i++) {
+        atomic_init(&ht->readers[i].epoch, 0);
+    }
+    atomic_init(&ht->globalEpoch, 1); // 0 means "not reading"
+    pthread_mutex_init(&ht->retireLock, NULL);
+    ht->retired = NULL;
+    ht->retiredCount = 0;
+    
+    return ht;
+}
+
+void freeConcurrentChainingHashTable(struct ConcurrentChainingHashTable* ht) {
+    // Caller guarantees no other thread is still using the table
+    if (ht) {
+        for (int i = 0; i < ht->size; i++) {
+            struct ConcurrentNode* current = atomic_load(&ht->table[i]);
+            while (current) {
+                struct ConcurrentNode* temp = current;
+                current = atomic_load(&current->next);
+                free(temp);
+            }
+        }
+        while (ht->retired) {
+            struct ConcurrentNode* next = ht->retired->retiredNext;
+            free(ht->retired);
+            ht->retired = next;
+        }
+        for (int i = 0; i < LOCK_STRIPES; i++) {
+            pthread_mutex_destroy(&ht->stripes[i]);
+        }
+        pthread_mutex_destroy(&ht->retireLock);
+        free(ht->table);
+        free(ht);
+    }
+}
+
+// Slot i is readers[i] in every table; a slot is owned by one live thread at a time
+atomic_int readerSlotTaken[MAX_READER_THREADS];
+pthread_key_t readerSlotKey;
+pthread_once_t readerSlotOnce = PTHREAD_ONCE_INIT;
+
+void releaseReaderSlot(void* value) {
+    // Runs when the owning thread exits. It is outside every search by then, so its
+    // epoch is 0 in all tables and the next owner starts clean
+    atomic_store(&readerSlotTaken[(int)(size_t)value - 1], 0);
+}
+
+void createReaderSlotKey(void) {
+    pthread_key_create(&readerSlotKey, releaseReaderSlot);
+}
+
+int readerSlot(void) {
+    // Each thread claims a free slot on first use and keeps it until it exits
+    static _Thread_local int slot = -1;
+    if (slot >= 0) {
+        return slot;
+    }
+    pthread_once(&readerSlotOnce, createReaderSlotKey);
+    for (int i = 0; i < MAX_READER_THREADS; i++) {
+        int expected = 0;
+        if (atomic_load_explicit(&readerSlotTaken[i], memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_strong(&readerSlotTaken[i], &expected, 1)) {
+            slot = i;
+            // The stored value must be non-NULL for the destructor to run
+            pthread_setspecific(readerSlotKey, (void*)(size_t)(i + 1));
+            return slot;
+        }
+    }
+    return -2; // All taken; the next search tries again
+}
+
+void reclaimRetiredNodes(struct ConcurrentChainingHashTable* ht) {
+    // Called with retireLock held. A node retired in epoch e was unlinked before the
+    // global epoch moved past e, so only readers that announced e or earlier can hold it
+    unsigned long long oldest = ULLONG_MAX;
+    for (int i = 0; i < MAX_READER_THREADS; i++) {
+        unsigned long long epoch = atomic_load(&ht->readers[i].epoch);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    
+    struct ConcurrentNode** link = &ht->retired;
+    while (*link) {
+        struct ConcurrentNode* node = *link;
+        if (node->retiredEpoch < oldest) {
+            *link = node->retiredNext;
+            free(node);
+            ht->retiredCount--;
+        } else {
+            link = &node->retiredNext;
+        }
+    }
+}
+
+int insertConcurrentChaining(struct ConcurrentChainingHashTable* ht, int key) {
+    int index = hashFunctions[ht->hashFunction].function(key, ht->size);
+    pthread_mutex_t* stripe = &ht->stripes[index % LOCK_STRIPES];
+    
+    struct ConcurrentNode* newNode = (struct ConcurrentNode*)malloc(sizeof(struct ConcurrentNode));
+    newNode->data = key;
+    pthread_mutex_lock(stripe);
+    atomic_init(&newNode->next, atomic_load_explicit(&ht->table[index], memory_order_relaxed));
+    // Release publishes data and next before readers can see the node
+    atomic_store_explicit(&ht->table[index], newNode, memory_order_release);
+    pthread_mutex_unlock(stripe);
+    
+    return 1; // Insertion successful
+}
+
+int searchConcurrentChaining(struct ConcurrentChainingHashTable* ht, int key) {
+    int index = hashFunctions[ht->hashFunction].function(key, ht->size);
+    int slot = readerSlot();
+    int found = 0;
+    
+    if (slot < 0) {
+        pthread_mutex_lock(&ht->stripes[index % LOCK_STRIPES]);
+    } else {
+        atomic_store(&ht->readers[slot].epoch, atomic_load(&ht->globalEpoch));
+        // The announcement must be visible before the head is read; otherwise a writer
+        // could unlink and free a node this search is about to walk
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    
+    struct ConcurrentNode* current = atomic_load_explicit(&ht->table[index], memory_order_acquire);
+    while (current) {
+        if (current->data == key) {
+            found = 1;
+            break;
+        }
+        current = atomic_load_explicit(&current->next, memory_order_acquire);
+    }
+    
+    if (slot < 0) {
+        pthread_mutex_unlock(&ht->stripes[index % LOCK_STRIPES]);
+    } else {
+        atomic_store_explicit(&ht->readers[slot].epoch, 0, memory_order_release);
+    }
+    
+    return found ? index : -1;
+}
+
+int deleteConcurrentChaining(struct ConcurrentChainingHashTable* ht, int key) {
+    int index = hashFunctions[ht->hashFunction].function(key, ht->size);
+    pthread_mutex_t* stripe = &ht->stripes[index % LOCK_STRIPES];
+    
+    pthread_mutex_lock(stripe);
+    _Atomic(struct ConcurrentNode*)* link = &ht->table[index];
+    struct ConcurrentNode* current = atomic_load_explicit(link, memory_order_relaxed);
+    while (current && current->data != key) {
+        link = &current->next;
+        current = atomic_load_explicit(link, memory_order_relaxed);
+    }
+    if (current == NULL) {
+        pthread_mutex_unlock(stripe);
+        return 0; // Key not found
+    }
+    // Readers already on current keep following its next pointer, which stays valid
+    atomic_store(link, atomic_load_explicit(&current->next, memory_order_relaxed));
+    pthread_mutex_unlock(stripe);
+    
+    pthread_mutex_lock(&ht->retireLock);
+    current->retiredEpoch = atomic_fetch_add(&ht->globalEpoch, 1);
+    current->retiredNext = ht->retired;
+    ht->retired = current;
+    if (++ht->retiredCount >= RETIRE_BATCH) {
+        reclaimRetiredNodes(ht);
+    }
+    pthread_mutex_unlock(&ht->retireLock);
+    
+    return 1; // Deletion successful
+}
+
+// Key/Value Map Implementation
+struct KeyValueMap* createKeyValueMap(int size, enum CollisionStrategy strategy) {
+    struct KeyValueMap* map = (struct KeyValueMap*)malloc(sizeof(struct KeyValueMap));
+    map->strategy = strategy;
+    map->size = nextPrime(size); // Prime sizes let quadratic and double hashing reach enough slots
+    map->count = 0;
+    map->used = 0;
+    map->keyComparisons = 0;
+    map->slots = NULL;
+    map->chains = NULL;
+    
+    if (strategy == STRATEGY_CHAINING) {
+        map->chains = (struct KeyValueEntry**)calloc(map->size, sizeof(struct KeyValueEntry*));
+    } else {
+        map->slots = (struct KeyValueEntry*)calloc(map->size, sizeof(struct KeyValueEntry)); // All KV_EMPTY_HASH
+    }
+    
+    return map;
+}
+
+void freeKeyValueMap(struct KeyValueMap* map) {
+    if (map) {
+        for (int i = 0; i < map->size; i++) {
+            if (map->chains) {
+                struct KeyValueEntry* current = map->chains[i];
+                while (current) {
+                    struct KeyValueEntry* temp = current;
+                    current = current->next;
+                    free(temp->key);
+                    free(temp);
+                }
+            } else if (map->slots[i].hash > KV_DELETED_HASH) {
+                free(map->slots[i].key);
+            }
+        }
+        free(map->chains);
+        free(map->slots);
+        free(map);
+    }
+}
+
+unsigned long long hashBytes(const void* key, size_t keyLength) {
+    // Eight bytes at a time through mixBits; the length is folded in so "a" and "a\0" differ
+    const unsigned char* bytes = (const unsigned char*)key;
+    unsigned long long hash = 0x9E3779B97F4A7C15ULL ^ keyLength;
+    size_t i = 0;
+    
+    for (; i + 8 <= keyLength; i += 8) {
+        unsigned long long word;
+        memcpy(&word, bytes + i, 8);
+        hash = mixBits(hash ^ word);
+    }
+    if (i < keyLength) {
+        unsigned long long word = 0;
+        memcpy(&word, bytes + i, keyLength - i);
+        hash = mixBits(hash ^ word);
+    }
+    
+    return hash > KV_DELETED_HASH ? hash : hash + 2;
+}
+
+int keyValueSlot(struct KeyValueMap* map, unsigned long long hash, int i) {
+    unsigned long long home = hash % map->size;
+    unsigned long long offset;
+    
+    switch (map->strategy) {
+        case STRATEGY_QUADRATIC_PROBING:
+            offset = (unsigned long long)i * i;
+            break;
+        case STRATEGY_DOUBLE_HASHING:
+            // Any step in [1, size - 1] is coprime with a prime size
+            offset = (unsigned long long)i * (1 + (hash >> 32) % (map->size - 1));
+            break;
+        default:
+            offset = i;
+    }
+    return (int)((home + offset) % map->size);
+}
+
+int keyMatches(struct KeyValueMap* map, struct KeyValueEntry* entry, unsigned long long hash, const void* key, size_t keyLength) {
+    // Nearly every mismatch is settled by the stored hash, without touching the key bytes
+    if (entry->hash != hash || entry->keyLength != keyLength) {
+        return 0;
+    }
+    map->keyComparisons++;
+    return memcmp(entry->key, key, keyLength) == 0;
+}
+
+int findKeyValueSlot(struct KeyValueMap* map, unsigned long long hash, const void* key, size_t keyLength, int* freeSlot) {
+    // Returns the slot holding key or -1; *freeSlot gets the first reusable slot on the way, or -1
+    *freeSlot = -1;
+    for (int i = 0; i < map->size; i++) {
+        int index = keyValueSlot(map, hash, i);
+        struct KeyValueEntry* entry = &map->slots[index];
+        
+        if (entry->hash == KV_EMPTY_HASH) {
+            if (*freeSlot == -1) *freeSlot = index;
+            return -1;
+        }
+        if (entry->hash == KV_DELETED_HASH) {
+            if (*freeSlot == -1) *freeSlot = index;
+        } else if (keyMatches(map, entry, hash, key, keyLength)) {
+            return index;
+        }
+    }
+    
+    return -1; // Whole probe sequence visited
+}
+
+int resizeKeyValueMap(struct KeyValueMap* map, int newSize) {
+    // Only the stored hashes are needed to place entries again, the keys are not rehashed
+    struct KeyValueEntry* oldSlots = map->slots;
+    struct KeyValueEntry** oldChains = map->chains;
+    int oldSize = map->size;
+    
+    for (;;) {
+        map->size = newSize;
+        if (oldChains) {
+            map->chains = (struct KeyValueEntry**)calloc(newSize, sizeof(struct KeyValueEntry*));
+            for (int i = 0; i < oldSize; i++) {
+                struct KeyValueEntry* current = oldChains[i];
+                while (current) {
+                    struct KeyValueEntry* next = current->next;
+                    int index = (int)(current->hash % newSize);
+                    current->next = map->chains[index];
+                    map->chains[index] = current;
+                    current = next;
+                }
+            }
+            free(oldChains);
+            return 1;
+        }
+        
+        map->slots = (struct KeyValueEntry*)calloc(newSize, sizeof(struct KeyValueEntry));
+        int placed = 1;
+        for (int i = 0; i < oldSize && placed; i++) {
+            if (oldSlots[i].hash <= KV_DELETED_HASH) {
+                continue;
+            }
+            placed = 0;
+            for (int j = 0; j < newSize; j++) {
+                int index = keyValueSlot(map, oldSlots[i].hash, j);
+                if (map->slots[index].hash == KV_EMPTY_HASH) {
+                    map->slots[index] = oldSlots[i];
+                    placed = 1;
+                    break;
+                }
+            }
+        }
+        if (placed) {
+            free(oldSlots);
+            map->used = map->count;
+            return 1;
+        }
+        // A quadratic sequence ran out of reachable slots: try the next size up
+        free(map->slots);
+        if (newSize > INT_MAX / 2 - 1) {
+            map->slots = oldSlots;
+            map->size = oldSize;
+            return 0;
+        }
+        newSize = nextPrime(newSize * 2);
+    }
+}
+
+int putKeyValue(struct KeyValueMap* map, const void* key, size_t keyLength, long long value) {
+    // Returns 1 when key was added, 0 when its value was replaced
+    unsigned long long hash = hashBytes(key, keyLength);
+    
+    if (map->chains) {
+        int index = (int)(hash % map->size);
+        for (struct KeyValueEntry* current = map->chains[index]; current; current = current->next) {
+            if (keyMatches(map, current, hash, key, keyLength)) {
+                current->value = value;
+                return 0;
+            }
+        }
+        if (map->count + 1 > 2 * map->size) {
+            resizeKeyValueMap(map, nextPrime(map->size * 2));
+            index = (int)(hash % map->size);
+        }
+        struct KeyValueEntry* entry = (struct KeyValueEntry*)malloc(sizeof(struct KeyValueEntry));
+        entry->hash = hash;
+        entry->key = (char*)malloc(keyLength > 0 ? keyLength : 1);
+        memcpy(entry->key, key, keyLength);
+        entry->keyLength = keyLength;
+        entry->value = value;
+        entry->next = map->chains[index];
+        map->chains[index] = entry;
+        map->count++;
+        return 1;
+    }
+    
+    int freeSlot;
+    int index = findKeyValueSlot(map, hash, key, keyLength, &freeSlot);
+    if (index != -1) {
+        map->slots[index].value = value;
+        return 0;
+    }
+    // Same policy as the int tables: grow on load, rebuild in place once tombstones pile up
+    while (freeSlot == -1 || map->used + 1 > DEFAULT_MAX_LOAD_FACTOR * map->size) {
+        int newSize = (map->count + 1) * 2.0 > DEFAULT_MAX_LOAD_FACTOR * map->size || freeSlot == -1
+                      ? nextPrime(map->size * 2) : map->size;
+        if (!resizeKeyValueMap(map, newSize)) {
+            return 0;
+        }
+        findKeyValueSlot(map, hash, key, keyLength, &freeSlot);
+    }
+    
+    struct KeyValueEntry* entry = &map->slots[freeSlot];
+    if (entry->hash == KV_EMPTY_HASH) {
+        map->used++;
+    }
+    entry->hash = hash;
+    entry->key = (char*)malloc(keyLength > 0 ? keyLength : 1);
+    memcpy(entry->key, key, keyLength);
+    entry->keyLength = keyLength;
+    entry->value = value;
+    map->count++;
+    return 1;
+}
+
+int getKeyValue(struct KeyValueMap* map, const void* key, size_t keyLength, long long* value) {
+    unsigned long long hash = hashBytes(key, keyLength);
+    
+    if (map->chains) {
+        for (struct KeyValueEntry* current = map->chains[hash % map->size]; current; current = current->next) {
+            if (keyMatches(map, current, hash, key, keyLength)) {
+                if (value) *value = current->value;
+                return 1; // Key found
+            }
+        }
+        return 0; // Key not found
+    }
+    
+    int freeSlot;
+    int index = findKeyValueSlot(map, hash, key, keyLength, &freeSlot);
+    if (index == -1) {
+        return 0; // Key not found
+    }
+    if (value) *value = map->slots[index].value;
+    return 1; // Key found
+}
+
+int deleteKeyValue(struct KeyValueMap* map, const void* key, size_t keyLength) {
+    unsigned long long hash = hashBytes(key, keyLength);
+    
+    if (map->chains) {
+        struct KeyValueEntry** link = &map->chains[hash % map->size];
+        for (; *link; link = &(*link)->next) {
+            if (keyMatches(map, *link, hash, key, keyLength)) {
+                struct KeyValueEntry* temp = *link;
+                *link = temp->next;
+                free(temp->key);
+                free(temp);
+                map->count--;
+                return 1; // Deletion successful
+            }
+        }
+        return 0; // Key not found
+    }
+    
+    int freeSlot;
+    int index = findKeyValueSlot(map, hash, key, keyLength, &freeSlot);
+    if (index == -1) {
+        return 0; // Key not found
+    }
+    free(map->slots[index].key);
+    map->slots[index].key = NULL;
+    map->slots[index].hash = KV_DELETED_HASH;
+    map->count--;
+    return 1; // Deletion successful
+}
+
+void printKeyValueMap(struct KeyValueMap* map) {
+    for (int i = 0; i < map->size; i++) {
+        printf("Index %d: ", i);
+        if (map->chains) {
+            struct KeyValueEntry* current = map->chains[i];
+            if (current == NULL) {
+                printf("Empty");
+            }
+            while (current) {
+                printf("%.*s = %lld", (int)current->keyLength, current->key, current->value);
+                current = current->next;
+                if (current) printf(" -> ");
+            }
+            printf("\n");
+        } else if (map->slots[i].hash == KV_EMPTY_HASH) {
+            printf("Empty\n");
+        } else if (map->slots[i].hash == KV_DELETED_HASH) {
+            printf("Deleted\n");
+        } else {
+            printf("%.*s = %lld\n", (int)map->slots[i].keyLength, map->slots[i].key, map->slots[i].value);
+        }
+    }
+}
+
+// Persistent File Implementation
+int saveOpenAddressingHashTable(struct OpenAddressingHashTable* ht, enum ProbeSequence probe, const char* path) {
+    HashFunction hash = hashFunctions[ht->hashFunction].function;
+    if (ht->hashFunction == HASH_UNIVERSAL) {
+        return 0; // Its coefficients are drawn per process, so another run could not find the keys
+    }
+    
+    // Rebuild without tombstones, taking in keys still waiting in oldTable; quadratic
+    // and double hashing can fail to place a key at the same size, so grow then
+    int size = ht->size;
+    int* slots = NULL;
+    for (;;) {
+        slots = allocateEmptySlots(size);
+        int* deleted = (int*)calloc(size, sizeof(int));
+        int placed = slots != NULL && deleted != NULL;
+        for (int t = 0; t < 2 && placed; t++) {
+            int* table = t == 0 ? ht->table : ht->oldTable;
+            int* tableDeleted = t == 0 ? ht->deleted : ht->oldDeleted;
+            int tableSize = t == 0 ? ht->size : ht->oldSize;
+            for (int i = 0; table && i < tableSize && placed; i++) {
+                if (table[i] != -1 && !tableDeleted[i]) {
+                    int slot = placeKey(slots, deleted, size, table[i], probe, hash);
+                    if (slot < 0) {
+                        placed = 0;
+                    } else {
+                        writeKey(slots, deleted, size, slot, table[i], probe);
+                    }
+                }
+            }
+        }
+        free(deleted);
+        if (placed) {
+            break;
+        }
+        free(slots);
+        if (size > INT_MAX / 2 - 1 || slots == NULL) {
+            return 0;
+        }
+        size = nextTableSize(size);
+    }
+    
+    struct HashTableFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = HASH_FILE_MAGIC;
+    header.version = HASH_FILE_VERSION;
+    header.hashFunction = ht->hashFunction;
+    header.probe = probe;
+    header.size = size;
+    header.count = ht->count;
+    
+    FILE* file = fopen(path, "wb");
+    int written = file != NULL &&
+                  fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(slots, sizeof(int), size, file) == (size_t)size;
+    if (file && fclose(file) != 0) {
+        written = 0;
+    }
+    free(slots);
+    return written;
+}
+
+struct MappedHashTable* openMappedHashTable(const char* path) {
+    void* data = NULL;
+    size_t length = 0;
+#ifdef _WIN32
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileLength = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileLength > 0 && (data = malloc(fileLength)) != NULL && fread(data, 1, fileLength, file) != (size_t)fileLength) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    length = fileLength > 0 ? (size_t)fileLength : 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        length = (size_t)info.st_size;
+        data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            data = NULL;
+        }
+    }
+    close(fd); // The mapping stays valid without the descriptor
+#endif
+    if (data == NULL) {
+        return NULL;
+    }
+    
+    struct MappedHashTable* mapped = (struct MappedHashTable*)malloc(sizeof(struct MappedHashTable));
+    mapped->header = (const struct HashTableFileHeader*)data;
+    mapped->slots = (const int*)((const char*)data + sizeof(struct HashTableFileHeader));
+    mapped->data = data;
+    mapped->length = length;
+    
+    // Check everything a lookup relies on before trusting the file
+    const struct HashTableFileHeader* header = mapped->header;
+    if (length < sizeof(struct HashTableFileHeader) || header->magic != HASH_FILE_MAGIC ||
+        header->version != HASH_FILE_VERSION || header->hashFunction >= HASH_FUNCTION_COUNT ||
+        header->hashFunction == HASH_UNIVERSAL || header->probe > PROBE_ROBIN_HOOD || header->size <= 0 ||
+        length != sizeof(struct HashTableFileHeader) + (size_t)header->size * sizeof(int)) {
+        closeMappedHashTable(mapped);
+        return NULL;
+    }
+    mapped->hash = hashFunctions[header->hashFunction].function;
+    return mapped;
+}
+
+int searchMappedHashTable(const struct MappedHashTable* mapped, int key) {
+    // Same probe sequences as findSlot, minus the tombstone checks the saved table does not need
+    const int* slots = mapped->slots;
+    int size = mapped->header->size;
+    enum ProbeSequence probe = (enum ProbeSequence)mapped->header->probe;
+    int index = mapped->hash(key, size);
+    int originalIndex = index;
+    int mask = (size & (size - 1)) == 0 ? size - 1 : -1;
+    int stride = probeStride(probe, key, size);
+    
+    for (int i = 0; i < size && slots[index] != -1; ) {
+        if (slots[index] == key) {
+            return index; // Key found
+        }
+        if (probe == PROBE_ROBIN_HOOD && displacement((int*)slots, size, index, mapped->hash) < i) {
+            break;
+        }
+        i++;
+        if (mask >= 0) {
+            index = (index + (probe == PROBE_QUADRATIC ? i : stride)) & mask;
+        } else {
+            index = (int)((originalIndex + probeOffset(probe, key, i, size)) % size);
+        }
+    }
+    
+    return -1; // Key not found
+}
+
+void closeMappedHashTable(struct MappedHashTable* mapped) {
+    if (mapped) {
+#ifdef _WIN32
+        free(mapped->data);
+#else
+        munmap(mapped->data, mapped->length);
+#endif
+        free(mapped);
+    }
+}
+
+// Perfect Hash Implementation
+int popCount64(unsigned long long word) {
+#ifdef __GNUC__
+    return __builtin_popcountll(word);
+#else
+    int n = 0;
+    for (; word; word &= word - 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+long long perfectHashPosition(int key, int level, long long levelSize) {
+    // A fresh mix per level, scaled into [0, levelSize) by its top 32 bits
+    unsigned long long hash = mixBits((unsigned int)key + (level + 1) * 0x9E3779B97F4A7C15ULL);
+    return (long long)(((hash >> 32) * (unsigned long long)levelSize) >> 32);
+}
+
+struct PerfectHashTable* createPerfectHash(const int* keys, int count, double gamma) {
+    struct PerfectHashTable* ph = (struct PerfectHashTable*)calloc(1, sizeof(struct PerfectHashTable));
+    
+    // Duplicates would collide at every level, so work on the distinct keys
+    int* remaining = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    if (count > 0) {
+        // keys may be NULL for an empty set, which memcpy and qsort do not allow
+        memcpy(remaining, keys, count * sizeof(int));
+        qsort(remaining, count, sizeof(int), compareInts);
+    }
+    int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        if (distinct == 0 || remaining[i] != remaining[distinct - 1]) {
+            remaining[distinct++] = remaining[i];
+        }
+    }
+    ph->count = distinct;
+    
+    int remainingCount = distinct;
+    long long totalBits = 0;
+    for (int level = 0; level < PERFECT_HASH_MAX_LEVELS && remainingCount > 0; level++) {
+        // Levels are whole words so each one starts on a word boundary
+        long long levelSize = (long long)(gamma * remainingCount) + 1;
+        levelSize = (levelSize + 63) / 64 * 64;
+        long long words = levelSize / 64;
+        unsigned long long* seen = (unsigned long long*)calloc(words, sizeof(unsigned long long));
+        unsigned long long* collided = (unsigned long long*)calloc(words, sizeof(unsigned long long));
+        for (int i = 0; i < remainingCount; i++) {
+            long long position = perfectHashPosition(remaining[i], level, levelSize);
+            unsigned long long bit = 1ULL << (position & 63);
+            if (seen[position >> 6] & bit) {
+                collided[position >> 6] |= bit;
+            }
+            seen[position >> 6] |= bit;
+        }
+        
+        // Keys alone at their position are done; the rest move on to the next level
+        ph->bits = (unsigned long long*)realloc(ph->bits, (totalBits / 64 + words) * sizeof(unsigned long long));
+        unsigned long long* levelBits = ph->bits + totalBits / 64;
+        for (long long w = 0; w < words; w++) {
+            levelBits[w] = seen[w] & ~collided[w];
+        }
+        int next = 0;
+        for (int i = 0; i < remainingCount; i++) {
+            long long position = perfectHashPosition(remaining[i], level, levelSize);
+            if (collided[position >> 6] & (1ULL << (position & 63))) {
+                remaining[next++] = remaining[i];
+            }
+        }
+        free(seen);
+        free(collided);
+        
+        ph->levelOffsets[level] = totalBits;
+        totalBits += levelSize;
+        ph->levelOffsets[level + 1] = totalBits;
+        ph->levelCount = level + 1;
+        remainingCount = next;
+    }
+    
+    // remaining is still sorted, so the leftovers can be binary searched as they are
+    ph->overflowCount = remainingCount;
+    ph->overflowKeys = (int*)malloc((remainingCount > 0 ? remainingCount : 1) * sizeof(int));
+    memcpy(ph->overflowKeys, remaining, remainingCount * sizeof(int));
+    free(remaining);
+    
+    long long blocks = totalBits / RANK_BLOCK_BITS + 1;
+    ph->ranks = (unsigned int*)malloc(blocks * sizeof(unsigned int));
+    unsigned int rank = 0;
+    for (long long w = 0; w < totalBits / 64; w++) {
+        if (w % (RANK_BLOCK_BITS / 64) == 0) {
+            ph->ranks[w / (RANK_BLOCK_BITS / 64)] = rank;
+        }
+        rank += popCount64(ph->bits[w]);
+    }
+    
+    ph->keys = (int*)malloc((distinct > 0 ? distinct : 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        ph->keys[perfectHashIndex(ph, keys[i])] = keys[i];
+    }
+    
+    return ph;
+}
+
+void freePerfectHash(struct PerfectHashTable* ph) {
+    if (ph) {
+        free(ph->bits);
+        free(ph->ranks);
+        free(ph->overflowKeys);
+        free(ph->keys);
+        free(ph);
+    }
+}
+
+int perfectHashIndex(const struct PerfectHashTable* ph, int key) {
+    // Index in [0, count) for any key of the set; keys outside it land on some index too, or -1
+    for (int level = 0; level < ph->levelCount; level++) {
+        long long levelSize = ph->levelOffsets[level + 1] - ph->levelOffsets[level];
+        long long bit = ph->levelOffsets[level] + perfectHashPosition(key, level, levelSize);
+        if (ph->bits[bit >> 6] & (1ULL << (bit & 63))) {
+            // Rank of the bit: the block's count plus the set bits before it inside the block
+            long long word = bit >> 6;
+            long long rank = ph->ranks[bit / RANK_BLOCK_BITS];
+            for (long long w = word & ~(long long)(RANK_BLOCK_BITS / 64 - 1); w < word; w++) {
+                rank += popCount64(ph->bits[w]);
+            }
+            return (int)(rank + popCount64(ph->bits[word] & ((1ULL << (bit & 63)) - 1)));
+        }
+    }
+    
+    int low = 0, high = ph->overflowCount - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (ph->overflowKeys[mid] == key) {
+            return ph->count - ph->overflowCount + mid;
+        }
+        if (ph->overflowKeys[mid] < key) low = mid + 1;
+        else high = mid - 1;
+    }
+    return -1;
+}
+
+int searchPerfectHash(struct PerfectHashTable* ph, int key) {
+    int index = perfectHashIndex(ph, key);
+    if (index != -1 && ph->keys[index] == key) {
+        return index; // Key found
+    }
+    return -1; // Key not found
+}
+
+void printPerfectHash(struct PerfectHashTable* ph) {
+    for (int i = 0; i < ph->count; i++) {
+        printf("Index %d: %d\n", i, ph->keys[i]);
+    }
+    printf("%d levels, %lld bits, %d keys in the overflow array\n", ph->levelCount,
+           ph->levelOffsets[ph->levelCount], ph->overflowCount);
+}
+
+// Cuckoo Hashing Implementation
+struct CuckooHashTable* createCuckooHashTable(int size) {
+    struct CuckooHashTable* ht = (struct CuckooHashTable*)malloc(sizeof(struct CuckooHashTable));
+    ht->bucketCount = (size + CUCKOO_BUCKET_SLOTS - 1) / CUCKOO_BUCKET_SLOTS;
+    if (ht->bucketCount < 2) ht->bucketCount = 2;
+    ht->count = 0;
+    ht->slots = allocateEmptySlots(ht->bucketCount * CUCKOO_BUCKET_SLOTS);
+    ht->stashCount = 0;
+    ht->seed = 0x5DEECE66DULL;
+    ht->kicks = 0;
+    
+    return ht;
+}
+
+void freeCuckooHashTable(struct CuckooHashTable* ht) {
+    if (ht) {
+        free(ht->slots);
+        free(ht);
+    }
+}
+
+void cuckooBuckets(struct CuckooHashTable* ht, int key, int* first, int* second) {
+    // One mix gives both choices: the high half picks the first bucket, the low half the second
+    unsigned long long hash = mixBits((unsigned int)key);
+    *first = reduceToRange(hash, ht->bucketCount);
+    *second = (int)(((hash & 0xFFFFFFFFULL) * (unsigned int)ht->bucketCount) >> 32);
+}
+
+int placeCuckooKey(struct CuckooHashTable* ht, int key, int* homeless) {
+    // Random walk: take a free slot in either bucket, otherwise evict a random
+    // resident of the current bucket and carry it to its other bucket
+    int first, second;
+    cuckooBuckets(ht, key, &first, &second);
+    int bucket = first;
+    
+    for (int kick = 0; kick <= CUCKOO_MAX_KICKS; kick++) {
+        int candidates[2] = { first, second };
+        for (int c = 0; c < 2; c++) {
+            int* slots = ht->slots + candidates[c] * CUCKOO_BUCKET_SLOTS;
+            for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+                if (slots[i] == -1) {
+                    slots[i] = key;
+                    ht->count++;
+                    return 1;
+                }
+            }
+        }
+        
+        int slot = bucket * CUCKOO_BUCKET_SLOTS + (int)(nextRandom(&ht->seed) % CUCKOO_BUCKET_SLOTS);
+        int victim = ht->slots[slot];
+        ht->slots[slot] = key;
+        key = victim;
+        ht->kicks++;
+        cuckooBuckets(ht, key, &first, &second);
+        bucket = first == bucket ? second : first;
+    }
+    
+    if (ht->stashCount < CUCKOO_STASH_SIZE) {
+        ht->stash[ht->stashCount++] = key;
+        ht->count++;
+        return 1;
+    }
+    *homeless = key; // Possibly not the key we started with, but the table is one key short either way
+    return 0;
+}
+
+int resizeCuckooTable(struct CuckooHashTable* ht, int bucketCount, int extraKey) {
+    // Rebuilt beside the old table, which stays intact until every key has a place
+    for (;;) {
+        struct CuckooHashTable rebuilt = *ht;
+        rebuilt.bucketCount = bucketCount;
+        rebuilt.count = 0;
+        rebuilt.stashCount = 0;
+        rebuilt.slots = allocateEmptySlots(bucketCount * CUCKOO_BUCKET_SLOTS);
+        if (rebuilt.slots == NULL) {
+            return 0;
+        }
+        
+        int placed = 1, homeless;
+        for (int i = 0; i < ht->bucketCount * CUCKOO_BUCKET_SLOTS && placed; i++) {
+            if (ht->slots[i] != -1) {
+                placed = placeCuckooKey(&rebuilt, ht->slots[i], &homeless);
+            }
+        }
+        for (int i = 0; i < ht->stashCount && placed; i++) {
+            placed = placeCuckooKey(&rebuilt, ht->stash[i], &homeless);
+        }
+        if (placed && extraKey != -1) {
+            placed = placeCuckooKey(&rebuilt, extraKey, &homeless);
+        }
+        
+        if (placed) {
+            free(ht->slots);
+            *ht = rebuilt;
+            return 1;
+        }
+        free(rebuilt.slots);
+        if (bucketCount > INT_MAX / (2 * CUCKOO_BUCKET_SLOTS)) {
+            return 0; // Cannot grow any further
+        }
+        bucketCount *= 2;
+    }
+}
+
+int insertCuckooTable(struct CuckooHashTable* ht, int key) {
+    if (key == -1) {
+        return 0; // -1 marks an empty slot and cannot be stored
+    }
+    if (searchCuckooTable(ht, key) != -1) {
+        return 0; // Key already exists
+    }
+    if (ht->count + 1 > CUCKOO_MAX_LOAD_FACTOR * ht->bucketCount * CUCKOO_BUCKET_SLOTS &&
+        !resizeCuckooTable(ht, ht->bucketCount * 2, -1)) {
+        return 0;
+    }
+    
+    int homeless;
+    if (placeCuckooKey(ht, key, &homeless)) {
+        return 1; // Insertion successful
+    }
+    // The walk failed with a full stash: grow, carrying the key left over from the walk
+    if (!resizeCuckooTable(ht, ht->bucketCount * 2, homeless)) {
+        return 0; // Out of memory
+    }
+    return 1; // Insertion successful
+}
+
+int searchCuckooTable(struct CuckooHashTable* ht, int key) {
+    if (key == -1) {
+        return -1; // Would match an empty slot
+    }
+    int first, second;
+    cuckooBuckets(ht, key, &first, &second);
+    int* firstSlots = ht->slots + first * CUCKOO_BUCKET_SLOTS;
+    int* secondSlots = ht->slots + second * CUCKOO_BUCKET_SLOTS;
+    PREFETCH(secondSlots);
+    
+    for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+        if (firstSlots[i] == key) {
+            return first * CUCKOO_BUCKET_SLOTS + i; // Key found
+        }
+    }
+    for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+        if (secondSlots[i] == key) {
+            return second * CUCKOO_BUCKET_SLOTS + i; // Key found
+        }
+    }
+    for (int i = 0; i < ht->stashCount; i++) {
+        if (ht->stash[i] == key) {
+            return ht->bucketCount * CUCKOO_BUCKET_SLOTS + i; // Stash entries are numbered after the last slot
+        }
+    }
+    
+    return -1; // Key not found
+}
+
+int deleteCuckooTable(struct CuckooHashTable* ht, int key) {
+    if (key == -1) {
+        return 0; // Never stored, see insertCuckooTable
+    }
+    int index = searchCuckooTable(ht, key);
+    if (index == -1) {
+        return 0; // Key not found
+    }
+    ht->count--;
+    
+    int slots = ht->bucketCount * CUCKOO_BUCKET_SLOTS;
+    if (index >= slots) {
+        ht->stash[index - slots] = ht->stash[--ht->stashCount];
+        return 1; // Deletion successful
+    }
+    ht->slots[index] = -1;
+    
+    // The freed slot may be one a stashed key was pushed out of; move it back so the stash stays short
+    int bucket = index / CUCKOO_BUCKET_SLOTS;
+    for (int i = 0; i < ht->stashCount; i++) {
+        int first, second;
+        cuckooBuckets(ht, ht->stash[i], &first, &second);
+        if (first == bucket || second == bucket) {
+            ht->slots[index] = ht->stash[i];
+            ht->stash[i] = ht->stash[--ht->stashCount];
+            break;
+        }
+    }
+    return 1; // Deletion successful
+}
+
+void printCuckooTable(struct CuckooHashTable* ht) {
+    for (int b = 0; b < ht->bucketCount; b++) {
+        printf("Bucket %d:", b);
+        for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+            int key = ht->slots[b * CUCKOO_BUCKET_SLOTS + i];
+            if (key == -1) {
+                printf(" Empty");
+            } else {
+                printf(" %d", key);
+            }
+        }
+        printf("\n");
+    }
+    printf("Stash:");
+    for (int i = 0; i < ht->stashCount; i++) {
+        printf(" %d", ht->stash[i]);
+    }
+    printf(ht->stashCount ? "\n" : " Empty\n");
+}
+
+// Swiss Table Implementation
+struct SwissHashTable* createSwissHashTable(int size) {
+    struct SwissHashTable* ht = (struct SwissHashTable*)malloc(sizeof(struct SwissHashTable));
+    int groupCount = 1;
+    while (groupCount * SWISS_GROUP_SIZE < size) {
+        groupCount *= 2;
+    }
+    ht->groupCount = groupCount;
+    ht->count = 0;
+    ht->tombstones = 0;
+    ht->control = (unsigned char*)malloc(groupCount * SWISS_GROUP_SIZE);
+    ht->keys = (int*)malloc(groupCount * SWISS_GROUP_SIZE * sizeof(int));
+    memset(ht->control, SWISS_EMPTY, groupCount * SWISS_GROUP_SIZE);
+    
+    return ht;
+}
+
+void freeSwissHashTable(struct SwissHashTable* ht) {
+    if (ht) {
+        free(ht->control);
+        free(ht->keys);
+        free(ht);
+    }
+}
+
+unsigned long long swissHash(int key) {
+    // Low 7 bits become the tag, the rest pick the group
+    unsigned long long h = (unsigned int)key * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+}
+
+unsigned int matchGroup(const unsigned char* control, unsigned char tag) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i*)control);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < SWISS_GROUP_SIZE; i++) {
+        if (control[i] == tag) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+int countTrailingZeros(unsigned int mask) {
+#ifdef __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int n = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+int resizeSwissTable(struct SwissHashTable* ht, int groupCount) {
+    unsigned char* oldControl = ht->control;
+    int* oldKeys = ht->keys;
+    int oldSlots = ht->groupCount * SWISS_GROUP_SIZE;
+    
+    unsigned char* control = (unsigned char*)malloc(groupCount * SWISS_GROUP_SIZE);
+    int* keys = (int*)malloc(groupCount * SWISS_GROUP_SIZE * sizeof(int));
+    if (control == NULL || keys == NULL) {
+        free(control);
+        free(keys);
+        return 0;
+    }
+    memset(control, SWISS_EMPTY, groupCount * SWISS_GROUP_SIZE);
+    ht->control = control;
+    ht->keys = keys;
+    ht->groupCount = groupCount;
+    ht->count = 0;
+    ht->tombstones = 0;
+    
+    for (int i = 0; i < oldSlots; i++) {
+        if (oldControl[i] < SWISS_EMPTY) {
+            insertSwissTable(ht, oldKeys[i]);
+        }
+    }
+    free(oldControl);
+    free(oldKeys);
+    return 1;
+}
+
+int insertSwissTable(struct SwissHashTable* ht, int key) {
+    if (searchSwissTable(ht, key) != -1) {
+        return 0; // Key already exists
+    }
+    // Keep at most 7/8 of the slots used so every probe sequence reaches an empty slot
+    if ((ht->count + ht->tombstones + 1) * 8 > ht->groupCount * SWISS_GROUP_SIZE * 7) {
+        int groupCount = ht->count * 2 >= ht->groupCount * SWISS_GROUP_SIZE ? ht->groupCount * 2 : ht->groupCount;
+        if (!resizeSwissTable(ht, groupCount)) {
+            return 0;
+        }
+    }
+    
+    unsigned long long h = swissHash(key);
+    int mask = ht->groupCount - 1;
+    int group = (int)(h >> 7) & mask;
+    
+    for (int i = 1; ; i++) {
+        unsigned char* control = ht->control + group * SWISS_GROUP_SIZE;
+        unsigned int available = matchGroup(control, SWISS_EMPTY) | matchGroup(control, SWISS_DELETED);
+        if (available) {
+            int slot = group * SWISS_GROUP_SIZE + countTrailingZeros(available);
+            if (ht->control[slot] == SWISS_DELETED) {
+                ht->tombstones--;
+            }
+            ht->control[slot] = (unsigned char)(h & 0x7F);
+            ht->keys[slot] = key;
+            ht->count++;
+            return 1; // Insertion successful
+        }
+        group = (group + i) & mask; // Triangular steps visit every group
+    }
+}
+
+int searchSwissTable(struct SwissHashTable* ht, int key) {
+    unsigned long long h = swissHash(key);
+    unsigned char tag = (unsigned char)(h & 0x7F);
+    int mask = ht->groupCount - 1;
+    int group = (int)(h >> 7) & mask;
+    
+    for (int i = 1; i <= ht->groupCount; i++) {
+        unsigned char* control = ht->control + group * SWISS_GROUP_SIZE;
+        unsigned int candidates = matchGroup(control, tag);
+        while (candidates) {
+            int slot = group * SWISS_GROUP_SIZE + countTrailingZeros(candidates);
+            if (ht->keys[slot] == key) {
+                return slot; // Key found
+            }
+            candidates &= candidates - 1;
+        }
+        if (matchGroup(control, SWISS_EMPTY)) {
+            break; // The key would have been placed in this group
+        }
+        group = (group + i) & mask;
+    }
+    
+    return -1; // Key not found
+}
+
+int deleteSwissTable(struct SwissHashTable* ht, int key) {
+    int slot = searchSwissTable(ht, key);
+    if (slot == -1) {
+        return 0; // Key not found
+    }
+    // A group that already has an empty slot ends every probe that reaches it,
+    // so the slot can go straight back to empty
+    unsigned char* control = ht->control + (slot / SWISS_GROUP_SIZE) * SWISS_GROUP_SIZE;
+    if (matchGroup(control, SWISS_EMPTY)) {
+        ht->control[slot] = SWISS_EMPTY;
+    } else {
+        ht->control[slot] = SWISS_DELETED;
+        ht->tombstones++;
+    }
+    ht->count--;
+    return 1; // Deletion successful
+}
+
+void printSwissTable(struct SwissHashTable* ht) {
+    for (int i = 0; i < ht->groupCount * SWISS_GROUP_SIZE; i++) {
+        if (ht->control[i] == SWISS_EMPTY) {
+            printf("Index %d: Empty\n", i);
+        } else if (ht->control[i] == SWISS_DELETED) {
+            printf("Index %d: Deleted\n", i);
+        } else {
+            printf("Index %d: %d (tag 0x%02X)\n", i, ht->keys[i], ht->control[i]);
+        }
+    }
+}
+
+// Benchmark Implementation
+long long nowNanoseconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+unsigned long long nextRandom(unsigned long long* state) {
+    // splitmix64: rand() only gives 15 bits on some platforms
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int compareLongLong(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+long long percentile(long long* sorted, int n, double p) {
+    int index = (int)(p * (n - 1));
+    return sorted[index];
+}
+
+void benchmarkResizing(int keyCount) {
+    const char* names[] = { "Linear", "Quadratic", "Double" };
+    long long* latencies = (long long*)malloc(keyCount * sizeof(long long));
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 42;
+    
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = (int)(nextRandom(&seed) >> 33);
+    }
+    
+    printf("%-10s %-14s %10s %10s %10s %12s %12s\n", "Probing", "Rehash", "p50(ns)", "p99(ns)", "p99.9(ns)", "max(ns)", "Mops/s");
+    for (int p = PROBE_LINEAR; p <= PROBE_DOUBLE; p++) {
+        // A batch of 0 rebuilds the whole table inside one insert, which is the old all-at-once behaviour
+        for (int incremental = 0; incremental <= 1; incremental++) {
+            struct OpenAddressingHashTable* ht = createResizableOpenAddressingHashTable(TABLE_SIZE, HASH_DIVISION,
+                DEFAULT_MAX_LOAD_FACTOR, DEFAULT_MAX_TOMBSTONE_FACTOR, incremental ? REHASH_BATCH : 0);
+            long long start = nowNanoseconds();
+            for (int i = 0; i < keyCount; i++) {
+                long long t0 = nowNanoseconds();
+                insertOpenAddressing(ht, keys[i], (enum ProbeSequence)p);
+                latencies[i] = nowNanoseconds() - t0;
+            }
+            long long total = nowNanoseconds() - start;
+            
+            qsort(latencies, keyCount, sizeof(long long), compareLongLong);
+            printf("%-10s %-14s %10lld %10lld %10lld %12lld %12.2f\n", names[p],
+                   incremental ? "incremental" : "all-at-once",
+                   percentile(latencies, keyCount, 0.50), percentile(latencies, keyCount, 0.99),
+                   percentile(latencies, keyCount, 0.999), latencies[keyCount - 1],
+                   keyCount * 1000.0 / total);
+            freeOpenAddressingHashTable(ht);
+        }
+    }
+    
+    free(keys);
+    free(latencies);
+}
+
+void benchmarkChurn(int keyCount) {
+    const char* names[] = { "Linear", "Quadratic", "Double", "Robin Hood" };
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    
+    // Fill to keyCount keys, then replace every key ten times over
+    printf("%-12s %14s %14s %14s %10s\n", "Probing", "churn(ns/op)", "hit(ns)", "miss(ns)", "size");
+    for (int p = PROBE_LINEAR; p <= PROBE_ROBIN_HOOD; p++) {
+        struct OpenAddressingHashTable* ht = createOpenAddressingHashTable(TABLE_SIZE);
+        unsigned long long seed = 7;
+        for (int i = 0; i < keyCount; i++) {
+            do {
+                keys[i] = (int)(nextRandom(&seed) >> 33);
+            } while (!insertOpenAddressing(ht, keys[i], (enum ProbeSequence)p));
+        }
+        
+        long long start = nowNanoseconds();
+        long long churnOps = 10LL * keyCount;
+        for (long long op = 0; op < churnOps; op++) {
+            int victim = (int)(nextRandom(&seed) % keyCount);
+            deleteOpenAddressing(ht, keys[victim], (enum ProbeSequence)p);
+            do {
+                keys[victim] = (int)(nextRandom(&seed) >> 33);
+            } while (!insertOpenAddressing(ht, keys[victim], (enum ProbeSequence)p));
+        }
+        long long churnTime = nowNanoseconds() - start;
+        
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            searchOpenAddressing(ht, keys[i], (enum ProbeSequence)p);
+        }
+        long long hitTime = nowNanoseconds() - start;
+        
+        // Fresh random keys out of 2^31 are almost never present
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            searchOpenAddressing(ht, (int)(nextRandom(&seed) >> 33), (enum ProbeSequence)p);
+        }
+        long long missTime = nowNanoseconds() - start;
+        
+        printf("%-12s %14.1f %14.1f %14.1f %10d\n", names[p], (double)churnTime / (2 * churnOps),
+               (double)hitTime / keyCount, (double)missTime / keyCount, ht->size);
+        freeOpenAddressingHashTable(ht);
+    }
+    
+    free(keys);
+}
+
+void benchmarkMissLookups(int keyCount) {
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 99;
+    struct OpenAddressingHashTable* linear = createOpenAddressingHashTable(TABLE_SIZE);
+    struct OpenAddressingHashTable* robinHood = createOpenAddressingHashTable(TABLE_SIZE);
+    struct SwissHashTable* swiss = createSwissHashTable(TABLE_SIZE);
+    
+    // One query in ten is a key that was inserted, the rest are fresh random keys
+    for (int i = 0; i < keyCount; i++) {
+        int key = (int)(nextRandom(&seed) >> 33);
+        insertLinearProbing(linear, key);
+        insertRobinHood(robinHood, key);
+        insertSwissTable(swiss, key);
+        queries[i] = i % 10 == 0 ? key : (int)(nextRandom(&seed) >> 33);
+    }
+    
+    long long found = 0;
+    long long start = nowNanoseconds();
+    for (int i = 0; i < keyCount; i++) found += searchLinearProbing(linear, queries[i]) != -1;
+    long long linearTime = nowNanoseconds() - start;
+    
+    start = nowNanoseconds();
+    for (int i = 0; i < keyCount; i++) found += searchRobinHood(robinHood, queries[i]) != -1;
+    long long robinHoodTime = nowNanoseconds() - start;
+    
+    start = nowNanoseconds();
+    for (int i = 0; i < keyCount; i++) found += searchSwissTable(swiss, queries[i]) != -1;
+    long long swissTime = nowNanoseconds() - start;
+    
+    printf("%-12s %16s %10s\n", "Table", "Mlookups/s", "slots");
+    printf("%-12s %16.2f %10d\n", "Linear", keyCount * 1000.0 / linearTime, linear->size);
+    printf("%-12s %16.2f %10d\n", "Robin Hood", keyCount * 1000.0 / robinHoodTime, robinHood->size);
+    printf("%-12s %16.2f %10d\n", "Swiss", keyCount * 1000.0 / swissTime, swiss->groupCount * SWISS_GROUP_SIZE);
+    printf("(%lld hits across all tables)\n", found);
+    
+    freeOpenAddressingHashTable(linear);
+    freeOpenAddressingHashTable(robinHood);
+    freeSwissHashTable(swiss);
+    free(queries);
+}
+
+void benchmarkHashFunctions(int keyCount) {
+    const char* keySetNames[] = { "sequential", "strided", "random" };
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    int size = 1;
+    while (size < keyCount) {
+        size *= 2; // Power of two sizes are where weak functions fall apart
+    }
+    int* buckets = (int*)malloc(size * sizeof(int));
+    // Pairs that would collide if every key landed in a uniformly random bucket
+    double expectedPairs = (double)keyCount * (keyCount - 1) / 2.0 / size;
+    
+    printf("%-18s %-11s %10s %12s %10s %10s\n", "Function", "Keys", "ns/hash", "collisions", "maxBucket", "empty%");
+    for (int set = 0; set < 3; set++) {
+        unsigned long long seed = 1234;
+        for (int i = 0; i < keyCount; i++) {
+            if (set == 0) {
+                keys[i] = i;
+            } else if (set == 1) {
+                keys[i] = (int)((i * 64LL) & INT_MAX); // Aligned ids, e.g. pointers or padded records
+            } else {
+                keys[i] = (int)(nextRandom(&seed) >> 33);
+            }
+        }
+        
+        for (int f = 0; f < HASH_FUNCTION_COUNT; f++) {
+            HashFunction hash = hashFunctions[f].function;
+            memset(buckets, 0, size * sizeof(int));
+            
+            long long start = nowNanoseconds();
+            for (int i = 0; i < keyCount; i++) {
+                buckets[hash(keys[i], size)]++;
+            }
+            long long elapsed = nowNanoseconds() - start;
+            
+            double pairs = 0;
+            int maxBucket = 0, empty = 0;
+            for (int b = 0; b < size; b++) {
+                pairs += (double)buckets[b] * (buckets[b] - 1) / 2.0;
+                if (buckets[b] > maxBucket) maxBucket = buckets[b];
+                if (buckets[b] == 0) empty++;
+            }
+            
+            // collisions is relative to a random function, so 1.00 is ideal
+            printf("%-18s %-11s %10.2f %12.2f %10d %10.1f\n", hashFunctions[f].name, keySetNames[set],
+                   (double)elapsed / keyCount, expectedPairs > 0 ? pairs / expectedPairs : 0.0,
+                   maxBucket, 100.0 * empty / size);
+        }
+    }
+    
+    free(buckets);
+    free(keys);
+}
+
+void benchmarkNodePool(int keyCount) {
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    
+    printf("%-8s %14s %12s %12s %14s %10s\n", "Nodes", "allocations", "insert(ms)", "churn(ms)", "Mlookups/s", "free(ms)");
+    for (int pooled = 0; pooled <= 1; pooled++) {
+        struct ChainingHashTable* ht = pooled ? createPooledChainingHashTable(keyCount, HASH_MULTIPLY_XORSHIFT)
+                                              : createChainingHashTableWithHash(keyCount, HASH_MULTIPLY_XORSHIFT);
+        unsigned long long seed = 2024;
+        
+        long long start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            keys[i] = (int)(nextRandom(&seed) >> 33);
+            insertChaining(ht, keys[i]);
+        }
+        long long insertTime = nowNanoseconds() - start;
+        
+        // Replace half the keys so freed and new nodes interleave the way a long-running table does
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount / 2; i++) {
+            int victim = (int)(nextRandom(&seed) % keyCount);
+            deleteChaining(ht, keys[victim]);
+            keys[victim] = (int)(nextRandom(&seed) >> 33);
+            insertChaining(ht, keys[victim]);
+        }
+        long long churnTime = nowNanoseconds() - start;
+        
+        long long found = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            found += searchChaining(ht, keys[(int)(nextRandom(&seed) % keyCount)]) != -1;
+        }
+        long long lookupTime = nowNanoseconds() - start;
+        
+        long long allocations = ht->allocations;
+        start = nowNanoseconds();
+        freeChainingHashTable(ht);
+        long long freeTime = nowNanoseconds() - start;
+        
+        printf("%-8s %14lld %12.1f %12.1f %14.2f %10.1f\n", pooled ? "pooled" : "malloc", allocations,
+               insertTime / 1e6, churnTime / 1e6, keyCount * 1000.0 / lookupTime, freeTime / 1e6);
+        if (found != keyCount) {
+            printf("(only %lld of %d lookups hit)\n", found, keyCount);
+        }
+    }
+    
+    free(keys);
+}
+
+void benchmarkBucketLayout(int keyCount) {
+    const char* names[] = { "linked", "pooled", "buckets" };
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 77;
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = (int)(nextRandom(&seed) >> 33);
+    }
+    
+    printf("%-6s %-8s %12s %12s %10s\n", "load", "layout", "hit(M/s)", "miss(M/s)", "bytes/key");
+    for (int load = 1; load <= 4; load *= 4) {
+        int size = keyCount / load > 0 ? keyCount / load : 1;
+        for (int layout = 0; layout < 3; layout++) {
+            struct ChainingHashTable* ht;
+            if (layout == 0) {
+                ht = createChainingHashTableWithHash(size, HASH_MULTIPLY_XORSHIFT);
+            } else if (layout == 1) {
+                ht = createPooledChainingHashTable(size, HASH_MULTIPLY_XORSHIFT);
+            } else {
+                ht = createBucketChainingHashTable(size, HASH_MULTIPLY_XORSHIFT);
+            }
+            for (int i = 0; i < keyCount; i++) {
+                insertChaining(ht, keys[i]);
+            }
+            
+            long long start = nowNanoseconds();
+            for (int i = 0; i < keyCount; i++) {
+                searchChaining(ht, keys[(i * 7919LL) % keyCount]);
+            }
+            long long hitTime = nowNanoseconds() - start;
+            
+            start = nowNanoseconds();
+            for (int i = 0; i < keyCount; i++) {
+                searchChaining(ht, (int)(nextRandom(&seed) >> 33));
+            }
+            long long missTime = nowNanoseconds() - start;
+            
+            // Payload only, without malloc headers
+            double bytes;
+            if (layout == 2) {
+                bytes = (double)(size + ht->allocations - 1) * sizeof(struct CacheLineBucket);
+            } else {
+                bytes = (double)size * sizeof(struct Node*) + (double)keyCount * sizeof(struct Node);
+            }
+            printf("%-6d %-8s %12.2f %12.2f %10.1f\n", load, names[layout], keyCount * 1000.0 / hitTime,
+                   keyCount * 1000.0 / missTime, bytes / keyCount);
+            freeChainingHashTable(ht);
+        }
+    }
+    
+    free(keys);
+}
+
+void benchmarkBulkBuild(int keyCount, int maxThreads) {
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = (int)permuteKey((unsigned int)i);
+    }
+    
+    // Baseline: the same presized table filled by one insert call per key
+    printf("%-10s %8s %12s %10s\n", "Table", "threads", "Mkeys/s", "seconds");
+    long long start = nowNanoseconds();
+    struct OpenAddressingHashTable* serial = createOpenAddressingHashTableWithHash(nextPrime(keyCount * 2 + 1), HASH_MULTIPLY_XORSHIFT);
+    for (int i = 0; i < keyCount; i++) {
+        insertLinearProbing(serial, keys[i]);
+    }
+    long long elapsed = nowNanoseconds() - start;
+    printf("%-10s %8s %12.2f %10.3f\n", "Linear", "insert", keyCount * 1000.0 / elapsed, elapsed / 1e9);
+    freeOpenAddressingHashTable(serial);
+    
+    for (int chaining = 0; chaining < 2; chaining++) {
+        for (int threadCount = 1; threadCount <= maxThreads; threadCount = threadCount * 2 > maxThreads && threadCount < maxThreads ? maxThreads : threadCount * 2) {
+            struct OpenAddressingHashTable* linear = NULL;
+            struct ChainingHashTable* chains = NULL;
+            start = nowNanoseconds();
+            if (chaining) {
+                chains = bulkBuildChaining(keys, keyCount, HASH_MULTIPLY_XORSHIFT, threadCount);
+            } else {
+                linear = bulkBuildOpenAddressing(keys, keyCount, HASH_MULTIPLY_XORSHIFT, PROBE_LINEAR, threadCount);
+            }
+            elapsed = nowNanoseconds() - start;
+            printf("%-10s %8d %12.2f %10.3f\n", chaining ? "Chaining" : "Linear", threadCount,
+                   keyCount * 1000.0 / elapsed, elapsed / 1e9);
+            
+            int missing = 0;
+            for (int i = 0; i < keyCount; i += 97) {
+                missing += (chaining ? searchChaining(chains, keys[i]) : searchLinearProbing(linear, keys[i])) == -1;
+            }
+            if (missing > 0 || (linear && linear->count != keyCount)) {
+                printf("%-10s %d sampled keys missing\n", "", missing);
+            }
+            freeOpenAddressingHashTable(linear);
+            freeChainingHashTable(chains);
+        }
+    }
+    
+    free(keys);
+}
+
+void* runShardedLookups(void* arg) {
+    struct ShardedLookupWork* work = (struct ShardedLookupWork*)arg;
+    work->pinned = pinThreadToNumaNode(work->node);
+    work->found = 0;
+    long long start = nowNanoseconds();
+    for (int i = 0; i < work->count; i++) {
+        work->found += searchSharded(work->ht, work->queries[i]) != -1;
+    }
+    work->elapsed = nowNanoseconds() - start;
+    return NULL;
+}
+
+void benchmarkShardedTable(int keyCount) {
+    const int shardCounts[] = { 1, 4, 16, 64 };
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 31;
+    for (int i = 0; i < keyCount; i++) {
+        queries[i] = (int)permuteKey((unsigned int)(nextRandom(&seed) % keyCount));
+    }
+    
+    // Routing cost and shard balance; every shard starts small and grows on its own
+    printf("%-10s %8s %12s %12s %10s %10s %10s\n", "Table", "shards", "insert(M/s)", "lookup(M/s)",
+           "minKeys", "maxKeys", "maxProbe");
+    for (int chaining = 0; chaining < 2; chaining++) {
+        for (int c = 0; c < 4; c++) {
+            int shardCount = shardCounts[c];
+            int shardSize = chaining ? keyCount / shardCount + 1 : TABLE_SIZE;
+            struct ShardedHashTable* ht = createShardedHashTable(shardCount, shardSize,
+                chaining ? STRATEGY_CHAINING : STRATEGY_LINEAR_PROBING, HASH_MULTIPLY_XORSHIFT, NULL);
+            long long start = nowNanoseconds();
+            for (int i = 0; i < keyCount; i++) {
+                insertSharded(ht, (int)permuteKey((unsigned int)i));
+            }
+            long long insertTime = nowNanoseconds() - start;
+            
+            long long found = 0;
+            start = nowNanoseconds();
+            for (int i = 0; i < keyCount; i++) {
+                found += searchSharded(ht, queries[i]) != -1;
+            }
+            long long lookupTime = nowNanoseconds() - start;
+            
+            int minKeys = INT_MAX, maxKeys = 0;
+            for (int s = 0; s < shardCount; s++) {
+                int keys = chaining ? collectChainingStats(ht->chainingShards[s])->keys : ht->openShards[s]->count;
+                if (keys < minKeys) minKeys = keys;
+                if (keys > maxKeys) maxKeys = keys;
+            }
+            struct TableStats* stats = collectShardedStats(ht);
+            printf("%-10s %8d %12.2f %12.2f %10d %10d %10lld\n", chaining ? "Chaining" : "Linear", shardCount,
+                   keyCount * 1000.0 / insertTime, keyCount * 1000.0 / lookupTime, minKeys, maxKeys, stats->longestProbe);
+            if (found != keyCount || stats->keys != keyCount) {
+                printf("%-10s %lld of %d keys found, %d counted\n", "", found, keyCount, stats->keys);
+            }
+            freeShardedHashTable(ht);
+        }
+    }
+    
+    // Every shard on node 0, looked up from a thread on node 0 and from one on the last node
+    int nodeCount = numaNodeCount();
+    int* shardNodes = (int*)calloc(16, sizeof(int));
+    struct ShardedHashTable* ht = createShardedHashTable(16, TABLE_SIZE, STRATEGY_LINEAR_PROBING, HASH_MULTIPLY_XORSHIFT, shardNodes);
+    for (int i = 0; i < keyCount; i++) {
+        insertSharded(ht, (int)permuteKey((unsigned int)i));
+    }
+    printf("\n%d NUMA node(s), %d failed mbind calls\n", nodeCount, ht->bindFailures);
+    printf("%-10s %8s %12s\n", "Access", "node", "lookup(M/s)");
+    for (int remote = 0; remote < (nodeCount > 1 ? 2 : 1); remote++) {
+        struct ShardedLookupWork work = { ht, queries, keyCount, remote ? nodeCount - 1 : 0, 0, 0, 0 };
+        pthread_t thread;
+        pthread_create(&thread, NULL, runShardedLookups, &work);
+        pthread_join(thread, NULL);
+        printf("%-10s %8d %12.2f%s\n", remote ? "Remote" : "Local", work.node, keyCount * 1000.0 / work.elapsed,
+               work.pinned ? "" : " (thread not pinned)");
+    }
+    if (nodeCount < 2) {
+        printf("Remote access needs a second NUMA node\n");
+    }
+    freeShardedHashTable(ht);
+    free(shardNodes);
+    free(queries);
+}
+
+void* runConcurrentWorkload(void* arg) {
+    struct ConcurrentWorkload* work = (struct ConcurrentWorkload*)arg;
+    for (int i = 0; i < work->operations; i++) {
+        unsigned long long r = nextRandom(&work->seed);
+        int key = (int)((r >> 32) % work->keyRange);
+        if ((int)(r % 100) < work->readPercent) {
+            searchConcurrentChaining(work->ht, key);
+        } else if (r & 128) {
+            insertConcurrentChaining(work->ht, key);
+        } else {
+            deleteConcurrentChaining(work->ht, key);
+        }
+    }
+    return NULL;
+}
+
+void* runShortLivedReader(void* arg) {
+    // Returns non-NULL if the search took the lock-free path
+    searchConcurrentChaining((struct ConcurrentChainingHashTable*)arg, 0);
+    return (void*)(size_t)(readerSlot() >= 0);
+}
+void benchmarkConcurrentChaining(int keyCount, int maxThreads) {
+    const int readPercents[] = { 95, 50 };
+    const int operationsPerThread = 1000000;
+    pthread_t* threads = (pthread_t*)malloc(maxThreads * sizeof(pthread_t));
+    struct ConcurrentWorkload* work = (struct ConcurrentWorkload*)malloc(maxThreads * sizeof(struct ConcurrentWorkload));
+    
+    // Every row below starts fresh threads, so exited readers must hand their slots back
+    struct ConcurrentChainingHashTable* slotCheck = createConcurrentChainingHashTable(16, HASH_MULTIPLY_XORSHIFT);
+    int lockedReaders = 0;
+    for (int i = 0; i < 2 * MAX_READER_THREADS; i++) {
+        pthread_t reader;
+        void* lockFree;
+        pthread_create(&reader, NULL, runShortLivedReader, slotCheck);
+        pthread_join(reader, &lockFree);
+        lockedReaders += lockFree == NULL;
+    }
+    if (lockedReaders) {
+        printf("%d of %d short-lived readers fell back to the stripe lock\n", lockedReaders, 2 * MAX_READER_THREADS);
+    }
+    freeConcurrentChainingHashTable(slotCheck);
+    
+    printf("%-10s %8s %12s\n", "read/write", "threads", "Mops/s");
+    for (int mix = 0; mix < 2; mix++) {
+        struct ConcurrentChainingHashTable* ht = createConcurrentChainingHashTable(keyCount, HASH_MULTIPLY_XORSHIFT);
+        // Keys are drawn from twice the prefill, so inserts and deletes keep the size roughly level
+        for (int i = 0; i < keyCount; i++) {
+            insertConcurrentChaining(ht, i * 2);
+        }
+        
+        for (int threadCount = 1; threadCount <= maxThreads; threadCount = threadCount * 2 > maxThreads && threadCount < maxThreads ? maxThreads : threadCount * 2) {
+            for (int t = 0; t < threadCount; t++) {
+                work[t].ht = ht;
+                work[t].keyRange = keyCount * 2;
+                work[t].operations = operationsPerThread;
+                work[t].readPercent = readPercents[mix];
+                work[t].seed = 1000 + t;
+            }
+            long long start = nowNanoseconds();
+            for (int t = 0; t < threadCount; t++) {
+                pthread_create(&threads[t], NULL, runConcurrentWorkload, &work[t]);
+            }
+            for (int t = 0; t < threadCount; t++) {
+                pthread_join(threads[t], NULL);
+            }
+            long long elapsed = nowNanoseconds() - start;
+            
+            printf("%7d/%-2d %8d %12.2f\n", readPercents[mix], 100 - readPercents[mix], threadCount,
+                   (double)threadCount * operationsPerThread * 1000.0 / elapsed);
+        }
+        freeConcurrentChainingHashTable(ht);
+    }
+    
+    free(work);
+    free(threads);
+}
+
+void benchmarkBatchLookups(int keyCount) {
+    int* keys = (int*)calloc(keyCount, sizeof(int));
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    int* results = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 314;
+    struct OpenAddressingHashTable* linear = createOpenAddressingHashTableWithHash(TABLE_SIZE, HASH_MULTIPLY_XORSHIFT);
+    struct ChainingHashTable* chaining = createPooledChainingHashTable(keyCount, HASH_MULTIPLY_XORSHIFT);
+    
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = (int)(nextRandom(&seed) >> 33);
+    }
+    insertBatchOpenAddressing(linear, keys, keyCount, results, PROBE_LINEAR);
+    insertBatchChaining(chaining, keys, keyCount, results);
+    // Half hits, half misses, in an order unrelated to insertion
+    for (int i = 0; i < keyCount; i++) {
+        queries[i] = i % 2 ? keys[nextRandom(&seed) % keyCount] : (int)(nextRandom(&seed) >> 33);
+    }
+    
+    printf("%-18s %14s %14s\n", "Table", "single(M/s)", "batch(M/s)");
+    for (int table = 0; table < 2; table++) {
+        long long start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            results[i] = table == 0 ? searchLinearProbing(linear, queries[i]) : searchChaining(chaining, queries[i]);
+        }
+        long long singleTime = nowNanoseconds() - start;
+        
+        start = nowNanoseconds();
+        if (table == 0) {
+            searchBatchOpenAddressing(linear, queries, keyCount, results, PROBE_LINEAR);
+        } else {
+            searchBatchChaining(chaining, queries, keyCount, results);
+        }
+        long long batchTime = nowNanoseconds() - start;
+        
+        printf("%-18s %14.2f %14.2f\n", table == 0 ? "Linear Probing" : "Chaining (pooled)",
+               keyCount * 1000.0 / singleTime, keyCount * 1000.0 / batchTime);
+    }
+    
+    freeOpenAddressingHashTable(linear);
+    freeChainingHashTable(chaining);
+    free(results);
+    free(queries);
+    free(keys);
+}
+
+void benchmarkStringKeys(int keyCount) {
+    const char* strategyNames[] = { "Chaining", "Linear", "Quadratic", "Double" };
+    // Session-style keys share long prefixes, which is what makes the stored hash worth having
+    char (*keys)[48] = (char (*)[48])malloc(keyCount * sizeof(*keys));
+    char (*misses)[48] = (char (*)[48])malloc(keyCount * sizeof(*misses));
+    unsigned long long seed = 555;
+    for (int i = 0; i < keyCount; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "tenant:%03d:session:%016llx", i % 100, nextRandom(&seed));
+        snprintf(misses[i], sizeof(misses[i]), "tenant:%03d:session:%016llx", i % 100, nextRandom(&seed));
+    }
+    
+    printf("%-10s %10s %10s %10s %16s\n", "Strategy", "put(M/s)", "hit(M/s)", "miss(M/s)", "memcmp/lookup");
+    for (int strategy = 0; strategy < STRATEGY_COUNT; strategy++) {
+        struct KeyValueMap* map = createKeyValueMap(TABLE_SIZE, (enum CollisionStrategy)strategy);
+        
+        long long start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            putKeyValue(map, keys[i], strlen(keys[i]), i);
+        }
+        long long putTime = nowNanoseconds() - start;
+        
+        map->keyComparisons = 0;
+        long long value, found = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            const char* hit = keys[(i * 7919LL) % keyCount];
+            found += getKeyValue(map, hit, strlen(hit), &value);
+        }
+        long long hitTime = nowNanoseconds() - start;
+        
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) {
+            found += getKeyValue(map, misses[i], strlen(misses[i]), &value);
+        }
+        long long missTime = nowNanoseconds() - start;
+        
+        printf("%-10s %10.2f %10.2f %10.2f %16.3f\n", strategyNames[strategy], keyCount * 1000.0 / putTime,
+               keyCount * 1000.0 / hitTime, keyCount * 1000.0 / missTime, map->keyComparisons / (2.0 * keyCount));
+        freeKeyValueMap(map);
+    }
+    
+    free(misses);
+    free(keys);
+}
+
+void benchmarkWorstCaseLookups(int keyCount) {
+    const char* names[] = { "Linear", "Quadratic", "Double", "Cuckoo" };
+    const double load = 0.85;
+    int* queries = (int*)malloc(2 * keyCount * sizeof(int));
+    long long* latencies = (long long*)malloc(2 * keyCount * sizeof(long long));
+    
+    // Same fixed load for every table, half the lookups hit and half miss
+    printf("%-10s %8s %10s %10s %10s %10s %12s\n", "Table", "load", "p50(ns)", "p99(ns)", "p99.9(ns)", "max(ns)", "maxProbes");
+    for (int t = 0; t < 4; t++) {
+        struct OpenAddressingHashTable* open = NULL;
+        struct CuckooHashTable* cuckoo = NULL;
+        enum ProbeSequence probe = (enum ProbeSequence)(t < 3 ? t : 0);
+        int inserted = 0;
+        if (t < 3) {
+            open = createResizableOpenAddressingHashTable(nextPrime((int)(keyCount / load) + 1), HASH_DIVISION, 0, 0, 0);
+        } else {
+            cuckoo = createCuckooHashTable((int)(keyCount / load) + 1);
+        }
+        for (int i = 0; i < keyCount; i++) {
+            int key = (int)permuteKey((unsigned int)i);
+            inserted += open ? insertOpenAddressing(open, key, probe) : insertCuckooTable(cuckoo, key);
+            queries[2 * i] = key;
+            queries[2 * i + 1] = (int)permuteKey((unsigned int)(i + keyCount));
+        }
+        
+        if (open) resetTableStats(&open->stats);
+        for (int i = 0; i < 2 * keyCount; i++) {
+            long long t0 = nowNanoseconds();
+            if (open) searchOpenAddressing(open, queries[i], probe);
+            else searchCuckooTable(cuckoo, queries[i]);
+            latencies[i] = nowNanoseconds() - t0;
+        }
+        qsort(latencies, 2 * keyCount, sizeof(long long), compareLongLong);
+        
+        // Cuckoo never looks past its two buckets and the stash
+        long long maxProbes = open ? open->stats.longestProbe : 2 * CUCKOO_BUCKET_SLOTS + cuckoo->stashCount;
+        double actualLoad = open ? (double)inserted / open->size : (double)inserted / (cuckoo->bucketCount * CUCKOO_BUCKET_SLOTS);
+        printf("%-10s %8.2f %10lld %10lld %10lld %10lld %12lld\n", names[t], actualLoad,
+               percentile(latencies, 2 * keyCount, 0.50), percentile(latencies, 2 * keyCount, 0.99),
+               percentile(latencies, 2 * keyCount, 0.999), latencies[2 * keyCount - 1], maxProbes);
+        if (inserted < keyCount) {
+            printf("%-10s (%d inserts found no free slot)\n", "", keyCount - inserted);
+        }
+        if (cuckoo) {
+            // -1 is the empty-slot marker, so it must never look like a stored key
+            int countBefore = cuckoo->count;
+            if (searchCuckooTable(cuckoo, -1) != -1 || deleteCuckooTable(cuckoo, -1) || insertCuckooTable(cuckoo, -1) ||
+                cuckoo->count != countBefore) {
+                printf("%-10s key -1 was treated as stored\n", "");
+            }
+        }
+        
+        freeOpenAddressingHashTable(open);
+        freeCuckooHashTable(cuckoo);
+    }
+    
+    free(latencies);
+    free(queries);
+}
+
+void benchmarkMappedStartup(int keyCount) {
+    const char* names[] = { "Linear", "Quadratic", "Double", "Robin Hood" };
+    const char* path = "complete_hashing.table";
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    
+    // Startup by inserting every key again versus mapping a saved copy
+    printf("%-12s %12s %10s %10s %16s %16s\n", "Probing", "rebuild(ms)", "save(ms)", "open(ms)", "Mlookups/s heap", "Mlookups/s file");
+    for (int p = PROBE_LINEAR; p <= PROBE_ROBIN_HOOD; p++) {
+        long long start = nowNanoseconds();
+        struct OpenAddressingHashTable* ht = createOpenAddressingHashTableWithHash(TABLE_SIZE, HASH_MULTIPLY_XORSHIFT);
+        for (int i = 0; i < keyCount; i++) {
+            insertOpenAddressing(ht, (int)permuteKey((unsigned int)i), (enum ProbeSequence)p);
+        }
+        finishRehash(ht, (enum ProbeSequence)p);
+        long long rebuildTime = nowNanoseconds() - start;
+        
+        start = nowNanoseconds();
+        if (!saveOpenAddressingHashTable(ht, (enum ProbeSequence)p, path)) {
+            printf("%-12s could not write %s\n", names[p], path);
+            freeOpenAddressingHashTable(ht);
+            continue;
+        }
+        long long saveTime = nowNanoseconds() - start;
+        
+        start = nowNanoseconds();
+        struct MappedHashTable* mapped = openMappedHashTable(path);
+        long long openTime = nowNanoseconds() - start;
+        
+        // Every other query is a key that was never inserted
+        unsigned long long seed = 11;
+        for (int i = 0; i < keyCount; i++) {
+            unsigned int n = (unsigned int)(nextRandom(&seed) % keyCount);
+            queries[i] = (int)permuteKey(i % 2 ? n + keyCount : n);
+        }
+        long long found = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) found += searchOpenAddressing(ht, queries[i], (enum ProbeSequence)p) != -1;
+        long long heapTime = nowNanoseconds() - start;
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) found -= searchMappedHashTable(mapped, queries[i]) != -1;
+        long long fileTime = nowNanoseconds() - start;
+        
+        printf("%-12s %12.2f %10.2f %10.3f %16.2f %16.2f\n", names[p], rebuildTime / 1e6, saveTime / 1e6,
+               openTime / 1e6, keyCount * 1000.0 / heapTime, keyCount * 1000.0 / fileTime);
+        if (found != 0) {
+            printf("%-12s mapped table disagrees with the heap table\n", names[p]);
+        }
+        closeMappedHashTable(mapped);
+        freeOpenAddressingHashTable(ht);
+    }
+    
+    remove(path);
+    free(queries);
+}
+
+void benchmarkPerfectHash(int keyCount) {
+    int* keys = (int*)malloc(keyCount * sizeof(int));
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 21;
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = (int)permuteKey((unsigned int)i);
+    }
+    // Every other query is a key that is not in the set
+    for (int i = 0; i < keyCount; i++) {
+        unsigned int n = (unsigned int)(nextRandom(&seed) % keyCount);
+        queries[i] = (int)permuteKey(i % 2 ? n + keyCount : n);
+    }
+    
+    printf("%-14s %12s %14s %16s\n", "Table", "build(ms)", "bits/key", "Mlookups/s");
+    for (int g = 0; g < 3; g++) {
+        double gamma = g == 0 ? PERFECT_HASH_GAMMA : g == 1 ? 2.0 : 5.0;
+        long long start = nowNanoseconds();
+        struct PerfectHashTable* ph = createPerfectHash(keys, keyCount, gamma);
+        long long buildTime = nowNanoseconds() - start;
+        
+        long long found = 0;
+        start = nowNanoseconds();
+        for (int i = 0; i < keyCount; i++) found += searchPerfectHash(ph, queries[i]) != -1;
+        long long lookupTime = nowNanoseconds() - start;
+        
+        // Overhead beyond the keys themselves, which both tables store at 32 bits each
+        long long totalBits = ph->levelOffsets[ph->levelCount];
+        double bits = totalBits + (totalBits / RANK_BLOCK_BITS + 1) * 32.0 + ph->overflowCount * 32.0;
+        char name[32];
+        snprintf(name, sizeof(name), "Perfect g=%.1f", gamma);
+        printf("%-14s %12.2f %14.2f %16.2f\n", name, buildTime / 1e6, bits / keyCount, keyCount * 1000.0 / lookupTime);
+        if (found != keyCount / 2) {
+            printf("%-14s found %lld of %d keys\n", "", found, keyCount / 2);
+        }
+        freePerfectHash(ph);
+    }
+    
+    long long start = nowNanoseconds();
+    struct OpenAddressingHashTable* linear = createOpenAddressingHashTableWithHash(TABLE_SIZE, HASH_MULTIPLY_XORSHIFT);
+    for (int i = 0; i < keyCount; i++) {
+        insertLinearProbing(linear, keys[i]);
+    }
+    long long buildTime = nowNanoseconds() - start;
+    start = nowNanoseconds();
+    for (int i = 0; i < keyCount; i++) searchLinearProbing(linear, queries[i]);
+    long long lookupTime = nowNanoseconds() - start;
+    printf("%-14s %12.2f %14.2f %16.2f\n", "Linear", buildTime / 1e6, linear->size * 64.0 / keyCount - 32,
+           keyCount * 1000.0 / lookupTime);
+    freeOpenAddressingHashTable(linear);
+    
+    free(queries);
+    free(keys);
+}
+
+void benchmarkFilters(int keyCount) {
+    const char* filterNames[] = { "none", "bloom", "cuckoo" };
+    const double targets[] = { 0.01, 0.001 };
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 77;
+    
+    // Hits and misses are timed apart; misses are where the filter should pay off
+    printf("%-10s %-8s %8s %10s %12s %12s %10s\n", "Table", "Filter", "target", "bits/key", "hit(M/s)", "miss(M/s)", "actualFP");
+    for (int t = 0; t < 2; t++) {
+        for (int f = 0; f < 3; f++) {
+            for (int target = 0; target < (f == 0 ? 1 : 2); target++) {
+                struct ChainingHashTable* chaining = NULL;
+                struct OpenAddressingHashTable* linear = NULL;
+                struct MembershipFilter* filter = NULL;
+                if (f == 1) filter = createBloomFilter(keyCount, targets[target]);
+                if (f == 2) filter = createCuckooFilter(keyCount, targets[target]);
+                if (t == 0) {
+                    // Load factor 2 chains, so every miss walks about two nodes
+                    chaining = createChainingHashTableWithHash(keyCount / 2 + 1, HASH_MULTIPLY_XORSHIFT);
+                    if (filter) attachChainingFilter(chaining, filter);
+                } else {
+                    linear = createOpenAddressingHashTableWithHash(TABLE_SIZE, HASH_MULTIPLY_XORSHIFT);
+                    if (filter) attachOpenAddressingFilter(linear, filter);
+                }
+                for (int i = 0; i < keyCount; i++) {
+                    int key = (int)permuteKey((unsigned int)i);
+                    if (chaining) insertChaining(chaining, key);
+                    else insertLinearProbing(linear, key);
+                }
+                
+                long long found = 0;
+                for (int i = 0; i < keyCount; i++) {
+                    queries[i] = (int)permuteKey((unsigned int)(nextRandom(&seed) % keyCount));
+                }
+                long long start = nowNanoseconds();
+                for (int i = 0; i < keyCount; i++) {
+                    found += (chaining ? searchChaining(chaining, queries[i]) : searchLinearProbing(linear, queries[i])) != -1;
+                }
+                long long hitTime = nowNanoseconds() - start;
+                
+                for (int i = 0; i < keyCount; i++) {
+                    queries[i] = (int)permuteKey((unsigned int)(keyCount + nextRandom(&seed) % keyCount));
+                }
+                long long passedBefore = filter ? filter->lookups - filter->rejected : 0;
+                start = nowNanoseconds();
+                for (int i = 0; i < keyCount; i++) {
+                    found += (chaining ? searchChaining(chaining, queries[i]) : searchLinearProbing(linear, queries[i])) != -1;
+                }
+                long long missTime = nowNanoseconds() - start;
+                
+                double bitsPerKey = 0, falsePositives = 0;
+                if (filter) {
+                    bitsPerKey = f == 1 ? (double)filter->blockCount * BLOOM_BLOCK_BITS / keyCount
+                                        : (double)filter->blockCount * CUCKOO_FILTER_SLOTS * 16 / keyCount;
+                    falsePositives = (double)(filter->lookups - filter->rejected - passedBefore) / keyCount;
+                }
+                printf("%-10s %-8s %8.3f %10.2f %12.2f %12.2f %10.4f\n", t == 0 ? "Chaining" : "Linear", filterNames[f],
+                       filter ? targets[target] : 0.0, bitsPerKey, keyCount * 1000.0 / hitTime,
+                       keyCount * 1000.0 / missTime, falsePositives);
+                if (found != keyCount) {
+                    printf("%-10s %lld of %d hits found\n", "", found, keyCount);
+                }
+                freeChainingHashTable(chaining);
+                freeOpenAddressingHashTable(linear);
+            }
+        }
+    }
+    
+    // Tiny filters round up to their minimum size; every key added must still be found
+    for (int f = 1; f <= 2; f++) {
+        for (int expected = 0; expected <= 8; expected++) {
+            struct MembershipFilter* filter = f == 1 ? createBloomFilter(expected, 0.01) : createCuckooFilter(expected, 0.01);
+            int missing = 0;
+            for (int i = 0; i < expected + 2; i++) {
+                addToFilter(filter, (int)permuteKey((unsigned int)i));
+            }
+            for (int i = 0; i < expected + 2; i++) {
+                missing += !mayContain(filter, (int)permuteKey((unsigned int)i));
+            }
+            if (missing) {
+                printf("%s filter sized for %d keys lost %d of %d\n", filterNames[f], expected, missing, expected + 2);
+            }
+            freeMembershipFilter(filter);
+        }
+    }
+    
+    free(queries);
+}
+
+void benchmarkMaskIndexing(int keyCount) {
+    const char* probeNames[] = { "Linear", "Quadratic", "Double" };
+    const double loads[] = { 0.5, 0.75 };
+    int* queries = (int*)malloc(keyCount * sizeof(int));
+    unsigned long long seed = 55;
+    
+    // Same keys in a prime-sized and a power-of-two table of about the same size, from
+    // cache-resident up to keyCount slots; the hash scales without a division in both
+    printf("%-10s %10s %6s %10s %10s %12s %12s %12s %12s\n", "Probe", "slots", "load", "prime", "pow2",
+           "modHit(M/s)", "maskHit(M/s)", "modMiss(M/s)", "maskMiss(M/s)");
+    for (int slots = 1024; ; slots *= 8) {
+        if (slots > keyCount) slots = nextPowerOfTwo(keyCount);
+        for (int p = PROBE_LINEAR; p <= PROBE_DOUBLE; p++) {
+            for (int l = 0; l < 2; l++) {
+                int count = (int)(slots * loads[l]);
+                int queryCount = count < keyCount ? keyCount : count;
+                struct OpenAddressingHashTable* tables[2];
+                tables[0] = createResizableOpenAddressingHashTable(nextPrime(slots), HASH_MULTIPLY_XORSHIFT, 0, 0, 0);
+                tables[1] = createResizableOpenAddressingHashTable(slots, HASH_MULTIPLY_XORSHIFT, 0, 0, 0);
+                double rates[2][2];
+                for (int t = 0; t < 2; t++) {
+                    for (int i = 0; i < count; i++) {
+                        insertOpenAddressing(tables[t], (int)permuteKey((unsigned int)i), (enum ProbeSequence)p);
+                    }
+                    // Hits first, then keys that were never inserted
+                    for (int miss = 0; miss < 2; miss++) {
+                        long long found = 0;
+                        long long elapsed = 0;
+                        for (int done = 0; done < queryCount; done += keyCount) {
+                            int batch = queryCount - done < keyCount ? queryCount - done : keyCount;
+                            for (int i = 0; i < batch; i++) {
+                                queries[i] = (int)permuteKey((unsigned int)(miss * count + nextRandom(&seed) % count));
+                            }
+                            long long start = nowNanoseconds();
+                            for (int i = 0; i < batch; i++) {
+                                found += searchOpenAddressing(tables[t], queries[i], (enum ProbeSequence)p) != -1;
+                            }
+                            elapsed += nowNanoseconds() - start;
+                        }
+                        if (found != (miss ? 0 : queryCount)) {
+                            printf("%s: %lld of %d lookups wrong\n", probeNames[p], miss ? found : queryCount - found, queryCount);
+                        }
+                        rates[miss][t] = queryCount * 1000.0 / elapsed;
+                    }
+                }
+                printf("%-10s %10d %6.2f %10d %10d %12.2f %12.2f %12.2f %12.2f\n", probeNames[p], slots, loads[l],
+                       tables[0]->size, tables[1]->size, rates[0][0], rates[0][1], rates[1][0], rates[1][1]);
+                freeOpenAddressingHashTable(tables[0]);
+                freeOpenAddressingHashTable(tables[1]);
+            }
+        }
+        if (slots >= keyCount) {
+            break;
+        }
+    }
+    
+    free(queries);
 }
 
-// Double Hashing Implementation
-int doubleHashFunction(int key, int size) {
-    return PRIME - (key % PRIME);
+// Benchmark Harness Implementation
+const char* workloadNames[WORKLOAD_COUNT] = { "uniform", "zipf", "sequential", "adversarial" };
+const char* strategyNames[STRATEGY_COUNT] = { "chaining", "linear", "quadratic", "double" };
+
+unsigned int permuteKey(unsigned int i) {
+    // Xorshifts and odd multiplies are both invertible mod 2^31, so distinct
+    // inputs give distinct keys that still look random to the hash functions
+    i &= INT_MAX;
+    i ^= i >> 16;
+    i = (i * 0x45D9F3Bu) & INT_MAX;
+    i ^= i >> 13;
+    i = (i * 0x2C1B3C6Du) & INT_MAX;
+    i ^= i >> 16;
+    return i;
 }
 
-int insertDoubleHashing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    int i = 0;
-    
-    while (ht->table[index] != -1 && !ht->deleted[index]) {
-        if (ht->table[index] == key) {
-            return 0; // Key already exists
+long long chainingMemoryUsage(struct ChainingHashTable* ht) {
+    // Bytes the table asked for, without malloc's own headers
+    long long bytes = sizeof(struct ChainingHashTable) + (long long)ht->size * sizeof(struct Node*);
+    if (ht->buckets) {
+        bytes += (long long)ht->allocations * sizeof(struct CacheLineBucket);
+    } else if (ht->pool) {
+        for (struct NodeSlab* slab = ht->pool->slabs; slab; slab = slab->next) {
+            bytes += sizeof(struct NodeSlab);
         }
-        i++;
-        index = (originalIndex + i * doubleHashFunction(key, ht->size)) % ht->size;
-        if (i >= ht->size) {
-            return 0; // Table is full
+    } else {
+        for (int i = 0; i < ht->size; i++) {
+            for (struct Node* node = ht->table[i]; node; node = node->next) {
+                bytes += sizeof(struct Node);
+            }
         }
     }
-    
-    ht->table[index] = key;
-    ht->deleted[index] = 0;
-    return 1; // Insertion successful
+    return bytes;
 }
 
-int searchDoubleHashing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    int i = 0;
+long long openAddressingMemoryUsage(struct OpenAddressingHashTable* ht) {
+    return sizeof(struct OpenAddressingHashTable) + ((long long)ht->size + ht->oldSize) * 2 * sizeof(int);
+}
+
+int pickPosition(const struct BenchmarkOptions* options, int workload, int liveCount, const double* zipfCdf, int poolSize, unsigned long long* seed, int* cursor) {
+    if (workload == WORKLOAD_SEQUENTIAL) {
+        if (*cursor >= liveCount) *cursor = 0;
+        return (*cursor)++;
+    }
+    if (workload == WORKLOAD_ZIPF && options->zipfExponent > 0) {
+        // Smallest rank whose cumulative weight reaches u; ranks past the live keys wrap around
+        double u = (nextRandom(seed) >> 11) * (1.0 / 9007199254740992.0);
+        int low = 0, high = poolSize - 1;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (zipfCdf[mid] < u) low = mid + 1;
+            else high = mid;
+        }
+        return low % liveCount;
+    }
+    return (int)(nextRandom(seed) % liveCount);
+}
+
+void runBenchmarkCase(const struct BenchmarkOptions* options, int workload, int strategy, int hashFunction, int* rowsPrinted) {
+    // keys[0, liveCount) are in the table, the rest of the pool is free for inserts
+    int poolSize = options->keys * 2;
+    int size = (int)(options->keys / options->loadFactor) + 1;
+    size = options->powerOfTwo ? nextPowerOfTwo(size) : nextPrime(size);
+    int* keys = (int*)malloc(poolSize * sizeof(int));
+    long long* latencies = (long long*)malloc(options->operations * sizeof(long long));
+    double* zipfCdf = NULL;
+    unsigned long long seed = options->seed;
     
-    while (ht->table[index] != -1 || ht->deleted[index]) {
-        if (ht->table[index] == key && !ht->deleted[index]) {
-            return index; // Key found
+    int groups = INT_MAX / size; // Multiples of size that still fit in an int
+    for (int i = 0; i < poolSize; i++) {
+        if (workload == WORKLOAD_SEQUENTIAL) {
+            keys[i] = i;
+        } else if (workload == WORKLOAD_ADVERSARIAL) {
+            // Every key is a small offset plus a multiple of size, so key % size takes only poolSize / groups values
+            keys[i] = (i % groups) * size + i / groups;
+        } else {
+            keys[i] = (int)permuteKey((unsigned int)i + (unsigned int)options->seed);
         }
-        i++;
-        index = (originalIndex + i * doubleHashFunction(key, ht->size)) % ht->size;
-        if (i >= ht->size || index == originalIndex) {
-            return -1; // Key not found or table full
+    }
+    if (workload == WORKLOAD_ZIPF) {
+        zipfCdf = (double*)malloc(poolSize * sizeof(double));
+        double total = 0;
+        for (int i = 0; i < poolSize; i++) {
+            total += 1.0 / pow(i + 1, options->zipfExponent);
+            zipfCdf[i] = total;
+        }
+        for (int i = 0; i < poolSize; i++) {
+            zipfCdf[i] /= total;
         }
     }
     
-    return -1; // Key not found
+    struct ChainingHashTable* chaining = NULL;
+    struct OpenAddressingHashTable* open = NULL;
+    enum ProbeSequence probe = strategy == STRATEGY_QUADRATIC_PROBING ? PROBE_QUADRATIC :
+                               strategy == STRATEGY_DOUBLE_HASHING ? PROBE_DOUBLE : PROBE_LINEAR;
+    if (strategy == STRATEGY_CHAINING) {
+        chaining = createChainingHashTableWithHash(size, (enum HashFunctionId)hashFunction);
+    } else {
+        open = createResizableOpenAddressingHashTable(size, (enum HashFunctionId)hashFunction,
+            options->loadFactor, DEFAULT_MAX_TOMBSTONE_FACTOR, REHASH_BATCH);
+    }
+    // Weak functions can turn loading and the run itself quadratic, so both stop
+    // at the time budget and the row reports how much was actually done
+    long long budget = (long long)(options->timeBudget * 1e9);
+    long long deadline = nowNanoseconds() + budget;
+    int liveCount = 0;
+    for (; liveCount < options->keys; liveCount++) {
+        if (chaining) insertChaining(chaining, keys[liveCount]);
+        else insertOpenAddressing(open, keys[liveCount], probe);
+        if ((liveCount & 63) == 63 && nowNanoseconds() > deadline) {
+            liveCount++;
+            break;
+        }
+    }
+    int loaded = liveCount;
+    resetTableStats(chaining ? &chaining->stats : &open->stats);
+    
+    int cursor = 0;
+    long long found = 0;
+    probeCount = 0;
+    long long start = nowNanoseconds();
+    deadline = start + budget;
+    int operations = 0;
+    for (; operations < options->operations; operations++) {
+        int roll = (int)(nextRandom(&seed) % 100);
+        int isInsert = roll >= options->readPercent && roll < options->readPercent + options->insertPercent;
+        int isDelete = roll >= options->readPercent + options->insertPercent;
+        if (isInsert && liveCount == poolSize) isInsert = 0;
+        if (isDelete && liveCount == 0) isDelete = 0, isInsert = 1;
+        
+        long long t0 = nowNanoseconds();
+        if (operations > 0 && t0 > deadline) {
+            break;
+        }
+        if (isInsert) {
+            int position = liveCount + (int)(nextRandom(&seed) % (poolSize - liveCount));
+            int key = keys[position];
+            if (chaining) insertChaining(chaining, key);
+            else insertOpenAddressing(open, key, probe);
+            keys[position] = keys[liveCount];
+            keys[liveCount++] = key;
+        } else if (isDelete) {
+            int position = pickPosition(options, workload, liveCount, zipfCdf, poolSize, &seed, &cursor);
+            int key = keys[position];
+            if (chaining) deleteChaining(chaining, key);
+            else deleteOpenAddressing(open, key, probe);
+            keys[position] = keys[--liveCount];
+            keys[liveCount] = key;
+        } else {
+            int key;
+            if (liveCount < poolSize && (liveCount == 0 || (int)(nextRandom(&seed) % 100) < options->missPercent)) {
+                key = keys[liveCount + (int)(nextRandom(&seed) % (poolSize - liveCount))];
+            } else {
+                key = keys[pickPosition(options, workload, liveCount, zipfCdf, poolSize, &seed, &cursor)];
+            }
+            found += (chaining ? searchChaining(chaining, key) : searchOpenAddressing(open, key, probe)) != -1;
+        }
+        latencies[operations] = nowNanoseconds() - t0;
+    }
+    long long total = nowNanoseconds() - start;
+    long long probes = probeCount;
+    long long bytes = chaining ? chainingMemoryUsage(chaining) : openAddressingMemoryUsage(open);
+    
+    long long latencySum = 0;
+    for (int op = 0; op < operations; op++) {
+        latencySum += latencies[op];
+    }
+    qsort(latencies, operations, sizeof(long long), compareLongLong);
+    double opsPerSecond = operations * 1e9 / total;
+    double mean = (double)latencySum / operations;
+    double averageProbes = (double)probes / operations;
+    double bytesPerKey = liveCount > 0 ? (double)bytes / liveCount : 0.0;
+    long long p50 = percentile(latencies, operations, 0.50);
+    long long p99 = percentile(latencies, operations, 0.99);
+    long long p999 = percentile(latencies, operations, 0.999);
+    
+    if (options->json) {
+        printf("%s  {\"table\": \"%s\", \"hash\": \"%s\", \"workload\": \"%s\", \"keys\": %d, \"operations\": %d, "
+               "\"load\": %.2f, \"ops_per_sec\": %.0f, \"mean_ns\": %.1f, \"p50_ns\": %lld, \"p99_ns\": %lld, "
+               "\"p999_ns\": %lld, \"avg_probes\": %.3f, \"bytes_per_key\": %.2f",
+               *rowsPrinted ? ",\n" : "", strategyNames[strategy], hashFunctions[hashFunction].name,
+               workloadNames[workload], loaded, operations, options->loadFactor, opsPerSecond,
+               mean, p50, p99, p999, averageProbes, bytesPerKey);
+        if (options->stats) {
+            printf(", \"stats\": ");
+            printTableStatsJson(chaining ? collectChainingStats(chaining) : collectOpenAddressingStats(open));
+        }
+        printf("}");
+    } else {
+        printf("%s,%s,%s,%d,%d,%.2f,%.0f,%.1f,%lld,%lld,%lld,%.3f,%.2f\n", strategyNames[strategy],
+               hashFunctions[hashFunction].name, workloadNames[workload], loaded, operations,
+               options->loadFactor, opsPerSecond, mean, p50, p99, p999, averageProbes, bytesPerKey);
+    }
+    (*rowsPrinted)++;
+    fflush(stdout);
+    
+    if (chaining) freeChainingHashTable(chaining);
+    else freeOpenAddressingHashTable(open);
+    free(zipfCdf);
+    free(latencies);
+    free(keys);
 }
 
-int deleteDoubleHashing(struct OpenAddressingHashTable* ht, int key) {
-    int index = divisionMethod(key, ht->size);
-    int originalIndex = index;
-    int i = 0;
+void printBenchmarkUsage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --workload NAME   uniform, zipf, sequential, adversarial or all (default uniform)\n");
+    printf("  --table NAME      chaining, linear, quadratic, double or all (default all)\n");
+    printf("  --hash NAME       a hash function name such as Division, or all (default all)\n");
+    printf("  --keys N          keys loaded before timing (default 100000)\n");
+    printf("  --ops N           timed operations (default 1000000)\n");
+    printf("  --load F          starting load factor, below 1 (default 0.5)\n");
+    printf("  --read P          percent of operations that are lookups (default 90)\n");
+    printf("  --insert P        percent that are inserts, the rest are deletes (default 5)\n");
+    printf("  --miss P          percent of lookups for absent keys (default 0)\n");
+    printf("  --zipf S          Zipf exponent of the zipf workload (default 0.99)\n");
+    printf("  --seed N          random seed (default 1)\n");
+    printf("  --budget S        seconds of timed operations per case before it is cut short (default 5)\n");
+    printf("  --format FORMAT   csv or json (default csv)\n");
+    printf("  --stats           add each table's probe, cluster and resize statistics (json only)\n");
+    printf("  --pow2            power-of-two table sizes with mask indexing instead of prime sizes\n");
+}
+
+int parseBenchmarkOptions(int argc, char** argv, struct BenchmarkOptions* options) {
+    options->keys = 100000;
+    options->operations = 1000000;
+    options->loadFactor = 0.5;
+    options->readPercent = 90;
+    options->insertPercent = 5;
+    options->missPercent = 0;
+    options->zipfExponent = 0.99;
+    options->timeBudget = 5;
+    options->seed = 1;
+    options->workload = WORKLOAD_UNIFORM;
+    options->strategy = -1;
+    options->hashFunction = -1;
+    options->json = 0;
+    options->stats = 0;
+    options->powerOfTwo = 0;
     
-    while (ht->table[index] != -1 || ht->deleted[index]) {
-        if (ht->table[index] == key && !ht->deleted[index]) {
-            ht->deleted[index] = 1; // Mark as deleted
-            return 1; // Deletion successful
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            return 0;
         }
-        i++;
-        index = (originalIndex + i * doubleHashFunction(key, ht->size)) % ht->size;
-        if (i >= ht->size || index == originalIndex) {
-            return 0; // Key not found or table full
+        if (strcmp(argv[i], "--stats") == 0) {
+            options->stats = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--pow2") == 0) {
+            options->powerOfTwo = 1;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 0;
+        }
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "--keys") == 0) {
+            options->keys = atoi(value);
+        } else if (strcmp(argv[i - 1], "--ops") == 0) {
+            options->operations = atoi(value);
+        } else if (strcmp(argv[i - 1], "--load") == 0) {
+            options->loadFactor = atof(value);
+        } else if (strcmp(argv[i - 1], "--read") == 0) {
+            options->readPercent = atoi(value);
+        } else if (strcmp(argv[i - 1], "--insert") == 0) {
+            options->insertPercent = atoi(value);
+        } else if (strcmp(argv[i - 1], "--miss") == 0) {
+            options->missPercent = atoi(value);
+        } else if (strcmp(argv[i - 1], "--zipf") == 0) {
+            options->zipfExponent = atof(value);
+        } else if (strcmp(argv[i - 1], "--budget") == 0) {
+            options->timeBudget = atof(value);
+        } else if (strcmp(argv[i - 1], "--seed") == 0) {
+            options->seed = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--format") == 0) {
+            if (strcmp(value, "json") != 0 && strcmp(value, "csv") != 0) {
+                fprintf(stderr, "Unknown format %s\n", value);
+                return 0;
+            }
+            options->json = strcmp(value, "json") == 0;
+        } else if (strcmp(argv[i - 1], "--workload") == 0) {
+            options->workload = -2;
+            if (strcmp(value, "all") == 0) options->workload = -1;
+            for (int w = 0; w < WORKLOAD_COUNT; w++) {
+                if (strcmp(value, workloadNames[w]) == 0) options->workload = w;
+            }
+            if (options->workload == -2) {
+                fprintf(stderr, "Unknown workload %s\n", value);
+                return 0;
+            }
+        } else if (strcmp(argv[i - 1], "--table") == 0) {
+            options->strategy = -2;
+            if (strcmp(value, "all") == 0) options->strategy = -1;
+            for (int t = 0; t < STRATEGY_COUNT; t++) {
+                if (strcmp(value, strategyNames[t]) == 0) options->strategy = t;
+            }
+            if (options->strategy == -2) {
+                fprintf(stderr, "Unknown table %s\n", value);
+                return 0;
+            }
+        } else if (strcmp(argv[i - 1], "--hash") == 0) {
+            options->hashFunction = -2;
+            if (strcmp(value, "all") == 0) options->hashFunction = -1;
+            for (int f = 0; f < HASH_FUNCTION_COUNT; f++) {
+                if (strcmp(value, hashFunctions[f].name) == 0) options->hashFunction = f;
+            }
+            if (options->hashFunction == -2) {
+                fprintf(stderr, "Unknown hash function %s\n", value);
+                return 0;
+            }
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+            return 0;
         }
     }
     
-    return 0; // Key not found
+    if (options->keys < 1 || options->operations < 1 || options->loadFactor <= 0 || options->loadFactor >= 1 ||
+        options->readPercent < 0 || options->insertPercent < 0 || options->readPercent + options->insertPercent > 100 ||
+        options->missPercent < 0 || options->missPercent > 100 || options->zipfExponent < 0 || options->timeBudget <= 0) {
+        fprintf(stderr, "Option out of range\n");
+        return 0;
+    }
+    if (options->stats && !options->json) {
+        fprintf(stderr, "--stats needs --format json\n");
+        return 0;
+    }
+    return 1;
 }
 
-void printDoubleHashingHashTable(struct OpenAddressingHashTable* ht) {
-    for (int i = 0; i < ht->size; i++) {
-        if (ht->table[i] != -1 && !ht->deleted[i]) {
-            printf("Index %d: %d\n", i, ht->table[i]);
-        } else if (ht->deleted[i]) {
-            printf("Index %d: Deleted\n", i);
-        } else {
-            printf("Index %d: Empty\n", i);
+int runBenchmarkHarness(int argc, char** argv) {
+    struct BenchmarkOptions options;
+    if (!parseBenchmarkOptions(argc, argv, &options)) {
+        printBenchmarkUsage(argv[0]);
+        return strcmp(argv[1], "--help") == 0 ? 0 : 1;
+    }
+    
+    int rowsPrinted = 0;
+    if (options.json) {
+        printf("[\n");
+    } else {
+        printf("table,hash,workload,keys,operations,load,ops_per_sec,mean_ns,p50_ns,p99_ns,p999_ns,avg_probes,bytes_per_key\n");
+    }
+    for (int w = 0; w < WORKLOAD_COUNT; w++) {
+        if (options.workload != -1 && options.workload != w) continue;
+        for (int t = 0; t < STRATEGY_COUNT; t++) {
+            if (options.strategy != -1 && options.strategy != t) continue;
+            for (int f = 0; f < HASH_FUNCTION_COUNT; f++) {
+                if (options.hashFunction != -1 && options.hashFunction != f) continue;
+                runBenchmarkCase(&options, w, t, f, &rowsPrinted);
+            }
         }
     }
+    if (options.json) {
+        printf("\n]\n");
+    }
+    return 0;
 }
 
 // Main function with user interface
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return runBenchmarkHarness(argc, argv);
+    }
+    
     int choice, subChoice, key, result;
+    char text[64];
+    long long value;
     struct ChainingHashTable* chainingHT = createChainingHashTable(TABLE_SIZE);
+    struct ChainingHashTable* bucketChainingHT = createBucketChainingHashTable(TABLE_SIZE, HASH_DIVISION);
     struct OpenAddressingHashTable* linearHT = createOpenAddressingHashTable(TABLE_SIZE);
     struct OpenAddressingHashTable* quadraticHT = createOpenAddressingHashTable(TABLE_SIZE);
     struct OpenAddressingHashTable* doubleHT = createOpenAddressingHashTable(TABLE_SIZE);
+    struct OpenAddressingHashTable* robinHoodHT = createOpenAddressingHashTable(TABLE_SIZE);
+    struct SwissHashTable* swissHT = createSwissHashTable(TABLE_SIZE);
+    struct CuckooHashTable* cuckooHT = createCuckooHashTable(TABLE_SIZE);
+    struct KeyValueMap* keyValueMap = createKeyValueMap(TABLE_SIZE, STRATEGY_LINEAR_PROBING);
     
     do {
         printf("\n===== HASH TABLE IMPLEMENTATION =====\n");
         printf("1. Hash Functions\n");
         printf("2. Collision Resolution Methods\n");
-        printf("3. Exit\n");
+        printf("3. Benchmarks\n");
+        printf("4. Exit\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
         switch (choice) {
             case 1:
                 printf("\n===== HASH FUNCTIONS =====\n");
-                printf("1. Division Method\n");
-                printf("2. Mid-Square Method\n");
-                printf("3. Folding Method\n");
-                printf("4. Multiplication Method\n");
-                printf("5. Universal Hashing\n");
+                for (int i = 0; i < HASH_FUNCTION_COUNT; i++) {
+                    printf("%d. %s\n", i + 1, hashFunctions[i].name);
+                }
                 printf("Enter your choice: ");
                 scanf("%d", &subChoice);
                 
                 printf("Enter key: ");
                 scanf("%d", &key);
                 
+                if (subChoice >= 1 && subChoice <= HASH_FUNCTION_COUNT) {
+                    printf("Hash Index: %d\n", hashFunctions[subChoice - 1].function(key, TABLE_SIZE));
+                } else {
+                    printf("Invalid choice!\n");
+                }
+                break;
+
+            case 2:
+                printf("\n===== COLLISION RESOLUTION METHODS =====\n");
+                printf("1. Chaining\n");
+                printf("2. Linear Probing\n");
+                printf("3. Quadratic Probing\n");
+                printf("4. Double Hashing\n");
+                printf("5. Robin Hood Hashing\n");
+                printf("6. Swiss Table\n");
+                printf("7. Chaining With Cache-Line Buckets\n");
+                printf("8. String Key/Value Map\n");
+                printf("9. Cuckoo Hashing\n");
+                printf("Enter your choice: ");
+                scanf("%d", &subChoice);
+                
                 switch (subChoice) {
                     case 1:
-                        printf("Hash Index: %d\n", divisionMethod(key, TABLE_SIZE));
+                        do {
+                            printf("\n===== CHAINING =====\n");
+                            printf("1. Insert\n");
+                            printf("2. Search\n");
+                            printf("3. Delete\n");
+                            printf("4. Print Table\n");
+                            printf("5. Print Statistics\n");
+                            printf("6. Back to Main Menu\n");
+                            printf("Enter your choice: ");
+                            scanf("%d", &subChoice);
+                            
+                            switch (subChoice) {
+                                case 1:
+                                    printf("Enter key to insert: ");
+                                    scanf("%d", &key);
+                                    insertChaining(chainingHT, key);
+                                    break;
+                                case 2:
+                                    printf("Enter key to search: ");
+                                    scanf("%d", &key);
+                                    result = searchChaining(chainingHT, key);
+                                    if (result != -1) {
+                                        printf("Key %d found at index %d\n", key, result);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 3:
+                                    printf("Enter key to delete: ");
+                                    scanf("%d", &key);
+                                    result = deleteChaining(chainingHT, key);
+                                    if (result) {
+                                        printf("Key %d deleted successfully\n", key);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 4:
+                                    printf("Chaining Hash Table:\n");
+                                    printChainingHashTable(chainingHT);
+                                    break;
+                                case 5:
+                                    printTableStatsJson(collectChainingStats(chainingHT));
+                                    printf("\n");
+                                    break;
+                                case 6:
+                                    break;
+                                default:
+                                    printf("Invalid choice!\n");
+                            }
+                        } while (subChoice != 6);
                         break;
                     case 2:
-                        printf("Hash Index: %d\n", midSquareMethod(key, TABLE_SIZE));
-                        break;
+                    do {
+                        printf("\n===== LINEAR PROBING =====\n");
+                        printf("1. Insert\n");
+                        printf("2. Search\n");
+                        printf("3. Delete\n");
+                        printf("4. Print Table\n");
+                        printf("5. Print Statistics\n");
+                        printf("6. Back to Main Menu\n");
+                        printf("Enter your choice: ");
+                        scanf("%d", &subChoice);
+                        
+                        switch (subChoice) {
+                            case 1:
+                                printf("Enter key to insert: ");
+                                scanf("%d", &key);
+                                result = insertLinearProbing(linearHT, key);
+                                if (result) {
+                                    printf("Key %d inserted successfully\n", key);
+                                } else {
+                                    printf("Insertion failed, table might be full or key already exists\n");
+                                }
+                                break;
+                            case 2:
+                                printf("Enter key to search: ");
+                                scanf("%d", &key);
+                                result = searchLinearProbing(linearHT, key);
+                                if (result != -1) {
+                                    printf("Key %d found at index %d\n", key, result);
+                                } else {
+                                    printf("Key %d not found\n", key);
+                                }
+                                break;
+                            case 3:
+                                printf("Enter key to delete: ");
+                                scanf("%d", &key);
+                                result = deleteLinearProbing(linearHT, key);
+                                if (result) {
+                                    printf("Key %d deleted successfully\n", key);
+                                } else {
+                                    printf("Key %d not found\n", key);
+                                }
+                                break;
+                            case 4:
+                                printf("Linear Probing Hash Table:\n");
+                                printLinearProbingHashTable(linearHT);
+                                break;
+                            case 5:
+                                printTableStatsJson(collectOpenAddressingStats(linearHT));
+                                printf("\n");
+                                break;
+                            case 6:
+                                break;
+                            default:
+                                printf("Invalid choice!\n");
+                        }
+                    } while (subChoice != 6);
+                    break;
                     case 3:
-                        printf("Hash Index: %d\n", foldingMethod(key, TABLE_SIZE));
+                        do {
+                            printf("\n===== QUADRATIC PROBING =====\n");
+                            printf("1. Insert\n");
+                            printf("2. Search\n");
+                            printf("3. Delete\n");
+                            printf("4. Print Table\n");
+                            printf("5. Print Statistics\n");
+                            printf("6. Back to Main Menu\n");
+                            printf("Enter your choice: ");
+                            scanf("%d", &subChoice);
+                            
+                            switch (subChoice) {
+                                case 1:
+                                    printf("Enter key to insert: ");
+                                    scanf("%d", &key);
+                                    result = insertQuadraticProbing(quadraticHT, key);
+                                    if (result) {
+                                        printf("Key %d inserted successfully\n", key);
+                                    } else {
+                                        printf("Insertion failed, table might be full or key already exists\n");
+                                    }
+                                    break;
+                                case 2:
+                                    printf("Enter key to search: ");
+                                    scanf("%d", &key);
+                                    result = searchQuadraticProbing(quadraticHT, key);
+                                    if (result != -1) {
+                                        printf("Key %d found at index %d\n", key, result);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 3:
+                                    printf("Enter key to delete: ");
+                                    scanf("%d", &key);
+                                    result = deleteQuadraticProbing(quadraticHT, key);
+                                    if (result) {
+                                        printf("Key %d deleted successfully\n", key);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 4:
+                                    printf("Quadratic Probing Hash Table:\n");
+                                    printQuadraticProbingHashTable(quadraticHT);
+                                    break;
+                                case 5:
+                                    printTableStatsJson(collectOpenAddressingStats(quadraticHT));
+                                    printf("\n");
+                                    break;
+                                case 6:
+                                    break;
+                                default:
+                                    printf("Invalid choice!\n");
+                            }
+                        } while (subChoice != 6);
                         break;
                     case 4:
-                        printf("Hash Index: %d\n", multiplicationMethod(key, TABLE_SIZE));
+                        do {
+                            printf("\n===== DOUBLE HASHING =====\n");
+                            printf("1. Insert\n");
+                            printf("2. Search\n");
+                            printf("3. Delete\n");
+                            printf("4. Print Table\n");
+                            printf("5. Print Statistics\n");
+                            printf("6. Back to Main Menu\n");
+                            printf("Enter your choice: ");
+                            scanf("%d", &subChoice);
+                            
+                            switch (subChoice) {
+                                case 1:
+                                    printf("Enter key to insert: ");
+                                    scanf("%d", &key);
+                                    result = insertDoubleHashing(doubleHT, key);
+                                    if (result) {
+                                        printf("Key %d inserted successfully\n", key);
+                                    } else {
+                                        printf("Insertion failed, table might be full or key already exists\n");
+                                    }
+                                    break;
+                                case 2:
+                                    printf("Enter key to search: ");
+                                    scanf("%d", &key);
+                                    result = searchDoubleHashing(doubleHT, key);
+                                    if (result != -1) {
+                                        printf("Key %d found at index %d\n", key, result);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 3:
+                                    printf("Enter key to delete: ");
+                                    scanf("%d", &key);
+                                    result = deleteDoubleHashing(doubleHT, key);
+                                    if (result) {
+                                        printf("Key %d deleted successfully\n", key);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 4:
+                                    printf("Double Hashing Hash Table:\n");
+                                    printDoubleHashingHashTable(doubleHT);
+                                    break;
+                                case 5:
+                                    printTableStatsJson(collectOpenAddressingStats(doubleHT));
+                                    printf("\n");
+                                    break;
+                                case 6:
+                                    break;
+                                default:
+                                    printf("Invalid choice!\n");
+                            }
+                        } while (subChoice != 6);
                         break;
                     case 5:
-                        printf("Hash Index: %d\n", universalHashing(key, TABLE_SIZE));
-                        break;
-                    default:
-                        printf("Invalid choice!\n");
-                }
-                break;
-
-            case 2:
-                printf("\n===== COLLISION RESOLUTION METHODS =====\n");
-                printf("1. Chaining\n");
-                printf("2. Linear Probing\n");
-                printf("3. Quadratic Probing\n");
-                printf("4. Double Hashing\n");
-                printf("Enter your choice: ");
-                scanf("%d", &subChoice);
-                
-                switch (subChoice) {
-                    case 1:
                         do {
-                            printf("\n===== CHAINING =====\n");
+                            printf("\n===== ROBIN HOOD HASHING =====\n");
                             printf("1. Insert\n");
                             printf("2. Search\n");
                             printf("3. Delete\n");
                             printf("4. Print Table\n");
-                            printf("5. Back to Main Menu\n");
+                            printf("5. Print Statistics\n");
+                            printf("6. Back to Main Menu\n");
                             printf("Enter your choice: ");
                             scanf("%d", &subChoice);
                             
@@ -532,12 +5175,17 @@ int main() {
                                 case 1:
                                     printf("Enter key to insert: ");
                                     scanf("%d", &key);
-                                    insertChaining(chainingHT, key);
+                                    result = insertRobinHood(robinHoodHT, key);
+                                    if (result) {
+                                        printf("Key %d inserted successfully\n", key);
+                                    } else {
+                                        printf("Insertion failed, table might be full or key already exists\n");
+                                    }
                                     break;
                                 case 2:
                                     printf("Enter key to search: ");
                                     scanf("%d", &key);
-                                    result = searchChaining(chainingHT, key);
+                                    result = searchRobinHood(robinHoodHT, key);
                                     if (result != -1) {
                                         printf("Key %d found at index %d\n", key, result);
                                     } else {
@@ -547,7 +5195,7 @@ int main() {
                                 case 3:
                                     printf("Enter key to delete: ");
                                     scanf("%d", &key);
-                                    result = deleteChaining(chainingHT, key);
+                                    result = deleteRobinHood(robinHoodHT, key);
                                     if (result) {
                                         printf("Key %d deleted successfully\n", key);
                                     } else {
@@ -555,72 +5203,23 @@ int main() {
                                     }
                                     break;
                                 case 4:
-                                    printf("Chaining Hash Table:\n");
-                                    printChainingHashTable(chainingHT);
+                                    printf("Robin Hood Hash Table:\n");
+                                    printRobinHoodHashTable(robinHoodHT);
                                     break;
                                 case 5:
+                                    printTableStatsJson(collectOpenAddressingStats(robinHoodHT));
+                                    printf("\n");
+                                    break;
+                                case 6:
                                     break;
                                 default:
                                     printf("Invalid choice!\n");
                             }
-                        } while (subChoice != 5);
+                        } while (subChoice != 6);
                         break;
-                    case 2:
-                    do {
-                        printf("\n===== LINEAR PROBING =====\n");
-                        printf("1. Insert\n");
-                        printf("2. Search\n");
-                        printf("3. Delete\n");
-                        printf("4. Print Table\n");
-                        printf("5. Back to Main Menu\n");
-                        printf("Enter your choice: ");
-                        scanf("%d", &subChoice);
-                        
-                        switch (subChoice) {
-                            case 1:
-                                printf("Enter key to insert: ");
-                                scanf("%d", &key);
-                                result = insertLinearProbing(linearHT, key);
-                                if (result) {
-                                    printf("Key %d inserted successfully\n", key);
-                                } else {
-                                    printf("Insertion failed, table might be full or key already exists\n");
-                                }
-                                break;
-                            case 2:
-                                printf("Enter key to search: ");
-                                scanf("%d", &key);
-                                result = searchLinearProbing(linearHT, key);
-                                if (result != -1) {
-                                    printf("Key %d found at index %d\n", key, result);
-                                } else {
-                                    printf("Key %d not found\n", key);
-                                }
-                                break;
-                            case 3:
-                                printf("Enter key to delete: ");
-                                scanf("%d", &key);
-                                result = deleteLinearProbing(linearHT, key);
-                                if (result) {
-                                    printf("Key %d deleted successfully\n", key);
-                                } else {
-                                    printf("Key %d not found\n", key);
-                                }
-                                break;
-                            case 4:
-                                printf("Linear Probing Hash Table:\n");
-                                printLinearProbingHashTable(linearHT);
-                                break;
-                            case 5:
-                                break;
-                            default:
-                                printf("Invalid choice!\n");
-                        }
-                    } while (subChoice != 5);
-                    break;
-                    case 3:
+                    case 6:
                         do {
-                            printf("\n===== QUADRATIC PROBING =====\n");
+                            printf("\n===== SWISS TABLE =====\n");
                             printf("1. Insert\n");
                             printf("2. Search\n");
                             printf("3. Delete\n");
@@ -633,7 +5232,7 @@ int main() {
                                 case 1:
                                     printf("Enter key to insert: ");
                                     scanf("%d", &key);
-                                    result = insertQuadraticProbing(quadraticHT, key);
+                                    result = insertSwissTable(swissHT, key);
                                     if (result) {
                                         printf("Key %d inserted successfully\n", key);
                                     } else {
@@ -643,7 +5242,7 @@ int main() {
                                 case 2:
                                     printf("Enter key to search: ");
                                     scanf("%d", &key);
-                                    result = searchQuadraticProbing(quadraticHT, key);
+                                    result = searchSwissTable(swissHT, key);
                                     if (result != -1) {
                                         printf("Key %d found at index %d\n", key, result);
                                     } else {
@@ -653,7 +5252,7 @@ int main() {
                                 case 3:
                                     printf("Enter key to delete: ");
                                     scanf("%d", &key);
-                                    result = deleteQuadraticProbing(quadraticHT, key);
+                                    result = deleteSwissTable(swissHT, key);
                                     if (result) {
                                         printf("Key %d deleted successfully\n", key);
                                     } else {
@@ -661,8 +5260,8 @@ int main() {
                                     }
                                     break;
                                 case 4:
-                                    printf("Quadratic Probing Hash Table:\n");
-                                    printQuadraticProbingHashTable(quadraticHT);
+                                    printf("Swiss Table:\n");
+                                    printSwissTable(swissHT);
                                     break;
                                 case 5:
                                     break;
@@ -671,9 +5270,9 @@ int main() {
                             }
                         } while (subChoice != 5);
                         break;
-                    case 4:
+                    case 7:
                         do {
-                            printf("\n===== DOUBLE HASHING =====\n");
+                            printf("\n===== CHAINING WITH CACHE-LINE BUCKETS =====\n");
                             printf("1. Insert\n");
                             printf("2. Search\n");
                             printf("3. Delete\n");
@@ -686,7 +5285,107 @@ int main() {
                                 case 1:
                                     printf("Enter key to insert: ");
                                     scanf("%d", &key);
-                                    result = insertDoubleHashing(doubleHT, key);
+                                    insertChaining(bucketChainingHT, key);
+                                    break;
+                                case 2:
+                                    printf("Enter key to search: ");
+                                    scanf("%d", &key);
+                                    result = searchChaining(bucketChainingHT, key);
+                                    if (result != -1) {
+                                        printf("Key %d found at index %d\n", key, result);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 3:
+                                    printf("Enter key to delete: ");
+                                    scanf("%d", &key);
+                                    result = deleteChaining(bucketChainingHT, key);
+                                    if (result) {
+                                        printf("Key %d deleted successfully\n", key);
+                                    } else {
+                                        printf("Key %d not found\n", key);
+                                    }
+                                    break;
+                                case 4:
+                                    printf("Cache-Line Bucket Hash Table:\n");
+                                    printChainingHashTable(bucketChainingHT);
+                                    break;
+                                case 5:
+                                    break;
+                                default:
+                                    printf("Invalid choice!\n");
+                            }
+                        } while (subChoice != 5);
+                        break;
+                    case 8:
+                        do {
+                            printf("\n===== STRING KEY/VALUE MAP =====\n");
+                            printf("1. Put\n");
+                            printf("2. Get\n");
+                            printf("3. Delete\n");
+                            printf("4. Print Table\n");
+                            printf("5. Back to Main Menu\n");
+                            printf("Enter your choice: ");
+                            scanf("%d", &subChoice);
+                            
+                            switch (subChoice) {
+                                case 1:
+                                    printf("Enter key to put: ");
+                                    scanf("%63s", text);
+                                    printf("Enter value: ");
+                                    scanf("%lld", &value);
+                                    if (putKeyValue(keyValueMap, text, strlen(text), value)) {
+                                        printf("Key %s added\n", text);
+                                    } else {
+                                        printf("Key %s updated\n", text);
+                                    }
+                                    break;
+                                case 2:
+                                    printf("Enter key to get: ");
+                                    scanf("%63s", text);
+                                    if (getKeyValue(keyValueMap, text, strlen(text), &value)) {
+                                        printf("Key %s has value %lld\n", text, value);
+                                    } else {
+                                        printf("Key %s not found\n", text);
+                                    }
+                                    break;
+                                case 3:
+                                    printf("Enter key to delete: ");
+                                    scanf("%63s", text);
+                                    if (deleteKeyValue(keyValueMap, text, strlen(text))) {
+                                        printf("Key %s deleted successfully\n", text);
+                                    } else {
+                                        printf("Key %s not found\n", text);
+                                    }
+                                    break;
+                                case 4:
+                                    printf("String Key/Value Map:\n");
+                                    printKeyValueMap(keyValueMap);
+                                    break;
+                                case 5:
+                                    break;
+                                default:
+                                    printf("Invalid choice!\n");
+                            }
+                        } while (subChoice != 5);
+                        break;
+                    case 9:
+                        do {
+                            printf("\n===== CUCKOO HASHING =====\n");
+                            printf("1. Insert\n");
+                            printf("2. Search\n");
+                            printf("3. Delete\n");
+                            printf("4. Print Table\n");
+                            printf("5. Back to Main Menu\n");
+                            printf("Enter your choice: ");
+                            scanf("%d", &subChoice);
+                            
+                            switch (subChoice) {
+                                case 1:
+                                    printf("Enter key to insert: ");
+                                    scanf("%d", &key);
+                                    result = insertCuckooTable(cuckooHT, key);
                                     if (result) {
                                         printf("Key %d inserted successfully\n", key);
                                     } else {
@@ -696,7 +5395,7 @@ int main() {
                                 case 2:
                                     printf("Enter key to search: ");
                                     scanf("%d", &key);
-                                    result = searchDoubleHashing(doubleHT, key);
+                                    result = searchCuckooTable(cuckooHT, key);
                                     if (result != -1) {
                                         printf("Key %d found at index %d\n", key, result);
                                     } else {
@@ -706,7 +5405,7 @@ int main() {
                                 case 3:
                                     printf("Enter key to delete: ");
                                     scanf("%d", &key);
-                                    result = deleteDoubleHashing(doubleHT, key);
+                                    result = deleteCuckooTable(cuckooHT, key);
                                     if (result) {
                                         printf("Key %d deleted successfully\n", key);
                                     } else {
@@ -714,8 +5413,8 @@ int main() {
                                     }
                                     break;
                                 case 4:
-                                    printf("Double Hashing Hash Table:\n");
-                                    printDoubleHashingHashTable(doubleHT);
+                                    printf("Cuckoo Hash Table:\n");
+                                    printCuckooTable(cuckooHT);
                                     break;
                                 case 5:
                                     break;
@@ -729,17 +5428,164 @@ int main() {
                 }
                 break;
             case 3:
+                printf("\n===== BENCHMARKS =====\n");
+                printf("1. Insert Latency With Resizing\n");
+                printf("2. Lookups After Insert/Delete Churn\n");
+                printf("3. Miss-Heavy Lookups\n");
+                printf("4. Hash Function Quality and Speed\n");
+                printf("5. Chaining Node Pool\n");
+                printf("6. Chaining Bucket Layout\n");
+                printf("7. Concurrent Chaining Scaling\n");
+                printf("8. Batched Lookups With Prefetching\n");
+                printf("9. String Key/Value Map Strategies\n");
+                printf("10. Worst-Case Lookups, Probing vs Cuckoo\n");
+                printf("11. Startup From a Mapped Table File\n");
+                printf("12. Perfect Hash for a Fixed Key Set\n");
+                printf("13. Bloom and Cuckoo Filters in Front of Tables\n");
+                printf("14. Mask vs Modulo Indexing\n");
+                printf("15. Parallel Bulk Build\n");
+                printf("16. Sharded Table, Local vs Remote NUMA Node\n");
+                printf("Enter your choice: ");
+                scanf("%d", &subChoice);
+                
+                switch (subChoice) {
+                    case 1:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkResizing(key);
+                        }
+                        break;
+                    case 2:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkChurn(key);
+                        }
+                        break;
+                    case 3:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkMissLookups(key);
+                        }
+                        break;
+                    case 4:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkHashFunctions(key);
+                        }
+                        break;
+                    case 5:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkNodePool(key);
+                        }
+                        break;
+                    case 6:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkBucketLayout(key);
+                        }
+                        break;
+                    case 7:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        printf("Enter maximum number of threads: ");
+                        scanf("%d", &result);
+                        if (key > 0 && result > 0) {
+                            benchmarkConcurrentChaining(key, result);
+                        }
+                        break;
+                    case 8:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkBatchLookups(key);
+                        }
+                        break;
+                    case 9:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkStringKeys(key);
+                        }
+                        break;
+                    case 10:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkWorstCaseLookups(key);
+                        }
+                        break;
+                    case 11:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkMappedStartup(key);
+                        }
+                        break;
+                    case 12:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkPerfectHash(key);
+                        }
+                        break;
+                    case 13:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkFilters(key);
+                        }
+                        break;
+                    case 14:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkMaskIndexing(key);
+                        }
+                        break;
+                    case 15:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        printf("Enter maximum number of threads: ");
+                        scanf("%d", &result);
+                        if (key > 0 && result > 0) {
+                            benchmarkBulkBuild(key, result);
+                        }
+                        break;
+                    case 16:
+                        printf("Enter number of keys: ");
+                        scanf("%d", &key);
+                        if (key > 0) {
+                            benchmarkShardedTable(key);
+                        }
+                        break;
+                    default:
+                        printf("Invalid choice!\n");
+                }
+                break;
+            case 4:
                 printf("Exiting...\n");
                 break;  
             default:
                 printf("Invalid choice! Please try again.\n");
         }
-    } while (choice != 3);
+    } while (choice != 4);
     // Free allocated memory
     freeChainingHashTable(chainingHT);
+    freeChainingHashTable(bucketChainingHT);
     freeOpenAddressingHashTable(linearHT);
     freeOpenAddressingHashTable(quadraticHT);
     freeOpenAddressingHashTable(doubleHT);
+    freeOpenAddressingHashTable(robinHoodHT);
+    freeSwissHashTable(swissHT);
+    freeCuckooHashTable(cuckooHT);
+    freeKeyValueMap(keyValueMap);
     return 0;
 }
         